@@ -0,0 +1,63 @@
+/*
+ * arena.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include "arena.h"
+
+Arena::Arena(size_t initial_capacity) {
+  this->capacity_ = initial_capacity;
+  this->block_ = static_cast<char *>(::operator new(initial_capacity));
+  this->offset_ = 0;
+  this->overflow_bytes_ = 0;
+}
+
+Arena::~Arena() {
+  for (int i = 0; i < overflow_blocks_.size(); ++i) {
+    ::operator delete(overflow_blocks_[i]);
+  }
+  ::operator delete(block_);
+}
+
+void *Arena::Allocate(size_t bytes, size_t alignment) {
+  //round address up to requested alignment, block itself is
+  //only aligned for fundamental types
+  uintptr_t base = reinterpret_cast<uintptr_t>(block_);
+  size_t start = ((base + offset_ + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+
+  if (start + bytes <= capacity_) {
+    offset_ = start + bytes;
+    return block_ + start;
+  }
+
+  //main block is full, take a separate block from heap for now
+  //and remember its size so that next Reset() can grow main block
+  char *block = static_cast<char *>(::operator new(bytes + alignment - 1));
+  overflow_blocks_.push_back(block);
+  overflow_bytes_ += bytes + alignment;
+
+  uintptr_t address = reinterpret_cast<uintptr_t>(block);
+  return block + (((address + alignment - 1) & ~uintptr_t(alignment - 1)) - address);
+}
+
+void Arena::Reset() {
+  if (!overflow_blocks_.empty()) {
+    //last cycle did not fit in main block so replace it with
+    //a block big enough for everything that was allocated
+    for (int i = 0; i < overflow_blocks_.size(); ++i) {
+      ::operator delete(overflow_blocks_[i]);
+    }
+    overflow_blocks_.clear();
+
+    ::operator delete(block_);
+    capacity_ = max(capacity_ * 2, capacity_ + overflow_bytes_);
+    block_ = static_cast<char *>(::operator new(capacity_));
+    overflow_bytes_ = 0;
+  }
+
+  offset_ = 0;
+}
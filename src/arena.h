@@ -0,0 +1,114 @@
+/*
+ * arena.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A bump allocator. Allocations only move an offset forward inside
+ * one big block and are all released together by Reset(). If a cycle
+ * needs more memory than the block has, extra blocks are taken from
+ * the heap and on next Reset() they are merged into one bigger block,
+ * so after warm-up Allocate() never calls malloc.
+ */
+class Arena {
+public:
+  explicit Arena(size_t initial_capacity = 256 * 1024);
+  ~Arena();
+
+  void *Allocate(size_t bytes, size_t alignment = alignof(max_align_t));
+
+  /**
+   * Releases everything allocated since last Reset(). Memory handed
+   * out before this call must not be used anymore.
+   */
+  void Reset();
+
+private:
+  //arena owns raw memory so it is not copyable
+  Arena(const Arena &);
+  Arena &operator=(const Arena &);
+
+  char *block_;
+  size_t capacity_;
+  size_t offset_;
+
+  //blocks taken when main block ran out of space in current cycle
+  vector<char *> overflow_blocks_;
+  size_t overflow_bytes_;
+};
+
+/**
+ * STL allocator that takes memory from an Arena. Deallocation is a no-op,
+ * memory is given back when arena is Reset(). A default constructed
+ * allocator has no arena and behaves like std::allocator, so containers
+ * using it can still be created outside of a planning cycle.
+ *
+ * Only move construction takes arena along. A copy constructed container
+ * and one that is (move) assigned to keep or get heap memory, so copying
+ * is how values are kept past Reset(). Swap does exchange arenas.
+ */
+template<class T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+  typedef false_type propagate_on_container_copy_assignment;
+  typedef false_type propagate_on_container_move_assignment;
+  typedef true_type propagate_on_container_swap;
+
+  ArenaAllocator() : arena_(nullptr) {}
+  explicit ArenaAllocator(Arena *arena) : arena_(arena) {}
+
+  template<class U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena()) {}
+
+  T *allocate(size_t n) {
+    if (arena_ == nullptr) {
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T *>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, size_t) {
+    if (arena_ == nullptr) {
+      ::operator delete(p);
+    }
+  }
+
+  ArenaAllocator select_on_container_copy_construction() const {
+    return ArenaAllocator();
+  }
+
+  Arena *arena() const {
+    return arena_;
+  }
+
+private:
+  Arena *arena_;
+};
+
+template<class T, class U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+  return a.arena() == b.arena();
+}
+
+template<class T, class U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+  return a.arena() != b.arena();
+}
+
+template<class T>
+using ArenaVector = vector<T, ArenaAllocator<T> >;
+
+#endif /* ARENA_H_ */
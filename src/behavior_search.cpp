@@ -0,0 +1,165 @@
+/*
+ * behavior_search.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "behavior_search.h"
+
+BehaviorSearch::BehaviorSearch(int depth, double step_duration)
+    : depth_(depth),
+      step_duration_(step_duration) {
+  this->lanes_count_ = 0;
+  this->max_v_ = 0;
+  this->vehicles_count_ = 0;
+  this->best_value_ = 0;
+}
+
+BehaviorSearch::~BehaviorSearch() {
+}
+
+void BehaviorSearch::BuildGapStates(const vector<Vehicle> &vehicles, double ego_s, int lanes_count) {
+  const int steps_count = depth_ + 1;
+  vehicles_count_ = vehicles.size();
+
+  //assign/resize keep capacity so after first cycles nothing is allocated
+  predicted_s_.resize(steps_count * vehicles_count_);
+  predicted_v_.resize(steps_count * vehicles_count_);
+  for (int step = 0; step < steps_count; ++step) {
+    double t = step * step_duration_;
+    for (int i = 0; i < vehicles_count_; ++i) {
+      //distance to ego vehicle in (-MAX_S/2, MAX_S/2] so a vehicle just past
+      //end of track is ahead of us and not a whole lap behind
+      double distance = vehicles[i].s_at(t) - ego_s;
+      predicted_s_[step * vehicles_count_ + i] = 0.5 * MAX_S - fmod(0.5 * MAX_S - distance + 2 * MAX_S, MAX_S);
+      predicted_v_[step * vehicles_count_ + i] = vehicles[i].v_at(t);
+    }
+  }
+
+  //vehicles don't change lanes in predictions, so group them by lane once
+  //and then only sort each group by predicted s for every decision point
+  sorted_vehicles_.clear();
+  lane_offsets_.assign(steps_count * lanes_count + 1, 0);
+  for (int step = 0; step < steps_count; ++step) {
+    const double *step_s = &predicted_s_[step * vehicles_count_];
+    for (int lane = 0; lane < lanes_count; ++lane) {
+      int begin = sorted_vehicles_.size();
+      lane_offsets_[step * lanes_count + lane] = begin;
+      for (int i = 0; i < vehicles_count_; ++i) {
+        if (vehicles[i].lane == lane) {
+          sorted_vehicles_.push_back(i);
+        }
+      }
+      sort(sorted_vehicles_.begin() + begin, sorted_vehicles_.end(),
+           [step_s](int a, int b) { return step_s[a] < step_s[b]; });
+    }
+  }
+  lane_offsets_[steps_count * lanes_count] = sorted_vehicles_.size();
+}
+
+int BehaviorSearch::FindLeader(int step, int lane, double s) const {
+  const int table = step * lanes_count_ + lane;
+  const int *begin = sorted_vehicles_.data() + lane_offsets_[table];
+  const int *end = sorted_vehicles_.data() + lane_offsets_[table + 1];
+  const double *step_s = &predicted_s_[step * vehicles_count_];
+
+  const int *leader = lower_bound(begin, end, s,
+                                  [step_s](int vehicle, double value) { return step_s[vehicle] < value; });
+  return leader != end ? *leader : -1;
+}
+
+bool BehaviorSearch::IsGapFree(int step, int lane, double s) const {
+  //nearest vehicle at or ahead of s - SAFE_DISTANCE_BEHIND must also be
+  //beyond s + SAFE_DISTANCE_AHEAD, then nothing is in between
+  int vehicle = FindLeader(step, lane, s - SAFE_DISTANCE_BEHIND);
+  return vehicle == -1 || predicted_s_[step * vehicles_count_ + vehicle] > s + SAFE_DISTANCE_AHEAD;
+}
+
+double BehaviorSearch::Expand(int step, int lane, double s, double v) {
+  if (step == depth_) {
+    return 0;
+  }
+
+  const double delta_v = COMFORTABLE_ACCELERATION * step_duration_;
+  const double speeds[] = { v + delta_v, v, v - delta_v };
+
+  double best_value = -1e9;
+  for (int lane_change = -1; lane_change <= 1; ++lane_change) {
+    int target_lane = lane + lane_change;
+    if (target_lane < 0 || target_lane >= lanes_count_) {
+      continue;
+    }
+
+    //lane change needs a gap in target lane now and at next decision point
+    if (target_lane != lane && !IsGapFree(step, target_lane, s)) {
+      continue;
+    }
+
+    int leader = FindLeader(step, target_lane, s);
+
+    for (int i = 0; i < 3; ++i) {
+      double next_v = max(0.0, min(speeds[i], max_v_));
+      double next_s = s + (v + next_v) / 2 * step_duration_;
+
+      //follow leader if we would get too close to it
+      if (leader != -1) {
+        double leader_s = predicted_s_[(step + 1) * vehicles_count_ + leader];
+        double leader_v = predicted_v_[(step + 1) * vehicles_count_ + leader];
+        if (next_s > leader_s - SAFE_DISTANCE_AHEAD) {
+          next_s = max(s, leader_s - SAFE_DISTANCE_AHEAD);
+          next_v = min(next_v, max(0.0, leader_v));
+        }
+      }
+
+      if (target_lane != lane && !IsGapFree(step + 1, target_lane, next_s)) {
+        continue;
+      }
+
+      double value = next_s - s;
+      if (target_lane != lane) {
+        value -= LANE_CHANGE_PENALTY;
+      }
+      value += Expand(step + 1, target_lane, next_s, next_v);
+
+      if (step == 0 && value > first_lane_values_[target_lane]) {
+        first_lane_values_[target_lane] = value;
+      }
+      best_value = max(best_value, value);
+    }
+  }
+
+  return best_value;
+}
+
+void BehaviorSearch::Search(const vector<Vehicle> &vehicles,
+                            double ego_s,
+                            double ego_v,
+                            int ego_lane,
+                            int lanes_count,
+                            double max_v) {
+  lanes_count_ = lanes_count;
+  max_v_ = max_v;
+
+  BuildGapStates(vehicles, ego_s, lanes_count);
+
+  //search runs in s relative to ego vehicle, only distances made matter
+  first_lane_values_.assign(lanes_count, -1e9);
+  best_value_ = Expand(0, ego_lane, 0, ego_v);
+}
+
+double BehaviorSearch::Regret(int lane) const {
+  if (lane < 0 || lane >= first_lane_values_.size() || first_lane_values_[lane] <= -1e9) {
+    return 1.0;
+  }
+
+  //normalize by distance ego vehicle can make in whole horizon at max speed
+  double horizon_distance = max_v_ * depth_ * step_duration_;
+  if (horizon_distance <= 0) {
+    return 0.0;
+  }
+
+  return min(1.0, (best_value_ - first_lane_values_[lane]) / horizon_distance);
+}
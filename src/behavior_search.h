@@ -0,0 +1,103 @@
+/*
+ * behavior_search.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef BEHAVIOR_SEARCH_H_
+#define BEHAVIOR_SEARCH_H_
+
+#include <vector>
+#include "vehicle.h"
+
+using namespace std;
+
+/**
+ * Bounded depth search over sequences of maneuvers (keep lane, change
+ * left, change right, each with speed up, keep speed or slow down) at
+ * decision points `step_duration` seconds apart. Value of a sequence is
+ * the distance ego vehicle makes minus a penalty for each lane change,
+ * so it finds overtakes that need more than one lane change.
+ *
+ * Predictions of all vehicles per decision point and per-lane tables of
+ * vehicles sorted by s (gap states) are built once per search and shared
+ * by all branches, each gap lookup is then a binary search.
+ */
+class BehaviorSearch {
+public:
+  BehaviorSearch(int depth = 3, double step_duration = 1.0);
+  virtual ~BehaviorSearch();
+
+  /**
+   * @param ego_v  ego vehicle velocity in meters/second
+   * @param max_v  max velocity ego vehicle can go in meters/second
+   */
+  void Search(const vector<Vehicle> &vehicles,
+              double ego_s,
+              double ego_v,
+              int ego_lane,
+              int lanes_count,
+              double max_v);
+
+  /**
+   * @returns how much worse best sequence starting with move to given lane
+   * is compared to best sequence overall, between 0 (best) and 1 (worst
+   * or lane can't be reached in first step)
+   */
+  double Regret(int lane) const;
+
+private:
+  /**
+   * Builds per decision point predictions and per lane sorted tables,
+   * s of vehicles is relative to ego_s and wrapped around end of track
+   */
+  void BuildGapStates(const vector<Vehicle> &vehicles, double ego_s, int lanes_count);
+
+  /**
+   * @returns best value reachable from given state at decision point `step`
+   */
+  double Expand(int step, int lane, double s, double v);
+
+  /**
+   * @returns index (into vehicles) of nearest vehicle with s >= given s
+   * in lane at decision point, or -1
+   */
+  int FindLeader(int step, int lane, double s) const;
+
+  /**
+   * @returns true if no vehicle is within safe distance of s in lane at decision point
+   */
+  bool IsGapFree(int step, int lane, double s) const;
+
+  const int depth_;
+  const double step_duration_;
+
+  int lanes_count_;
+  double max_v_;
+
+  //predicted s (relative to ego vehicle) and v per decision point (0 = now),
+  //as [step][vehicle]
+  int vehicles_count_;
+  vector<double> predicted_s_;
+  vector<double> predicted_v_;
+
+  //per (step, lane) vehicle indexes sorted by predicted s,
+  //lane_offsets_ points to where each (step, lane) table starts
+  vector<int> sorted_vehicles_;
+  vector<int> lane_offsets_;
+
+  //best value of a sequence starting with move to lane
+  vector<double> first_lane_values_;
+  double best_value_;
+
+  const double SAFE_DISTANCE_AHEAD = 15;
+  const double SAFE_DISTANCE_BEHIND = 10;
+  //what a lane change costs, in meters of progress
+  const double LANE_CHANGE_PENALTY = 5;
+  const double COMFORTABLE_ACCELERATION = 2; // m/s^2
+  // The max s value before wrapping around the track back to 0
+  const double MAX_S = 6945.554;
+};
+
+#endif /* BEHAVIOR_SEARCH_H_ */
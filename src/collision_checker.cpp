@@ -0,0 +1,188 @@
+/*
+ * collision_checker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "collision_checker.h"
+
+CollisionChecker::CollisionChecker(double vehicle_radius)
+    : collision_distance_(2 * vehicle_radius) {
+}
+
+CollisionChecker::~CollisionChecker() {
+}
+
+bool CollisionChecker::IsBlockColliding(const double *s_values,
+                                        const double *d_values,
+                                        int first_point,
+                                        int candidate) const {
+  //times of points in block, each point is 0.02 secs after previous one
+  Block t = (Block::LinSpaced(BLOCK_SIZE, 0, BLOCK_SIZE - 1) + double(first_point)) * 0.02;
+
+  Eigen::Map<const Block> ego_s(s_values + first_point);
+  Eigen::Map<const Block> ego_d(d_values + first_point);
+
+  //same prediction as Vehicle::s_at, time stops running once vehicle does
+  Block moving_t = t.min(candidate_stop_t_[candidate]);
+  Block delta_s = candidate_s_[candidate] + (candidate_v_[candidate] + candidate_half_a_[candidate] * moving_t) * moving_t
+      - ego_s;
+  Block delta_d = candidate_d_[candidate] - ego_d;
+
+  return ((delta_s * delta_s + delta_d * delta_d) < collision_distance_ * collision_distance_).any();
+}
+
+int CollisionChecker::FindFirstCollision(const vector<Vehicle> &vehicles,
+                                         const FrenetTrajectory &trajectory,
+                                         int &vehicle_index) {
+  const int points_count = trajectory.s_values.size();
+  if (points_count == 0) {
+    return -1;
+  }
+
+  const double *s_values = trajectory.s_values.data();
+  const double *d_values = trajectory.d_values.data();
+  const double duration = (points_count - 1) * 0.02;
+
+  //bounding box of ego vehicle over whole trajectory
+  double min_s = s_values[0];
+  double max_s = s_values[0];
+  double min_d = d_values[0];
+  double max_d = d_values[0];
+  for (int i = 1; i < points_count; ++i) {
+    min_s = min(min_s, s_values[i]);
+    max_s = max(max_s, s_values[i]);
+    min_d = min(min_d, d_values[i]);
+    max_d = max(max_d, d_values[i]);
+  }
+
+  //only vehicles whose bounding box is within collision distance of it
+  //can collide, usually this leaves none or only a few
+  candidates_.clear();
+  candidate_s_.clear();
+  candidate_v_.clear();
+  candidate_half_a_.clear();
+  candidate_stop_t_.clear();
+  candidate_d_.clear();
+  const int vehicles_count = vehicles.size();
+  for (int i = 0; i < vehicles_count; ++i) {
+    const Vehicle &vehicle = vehicles[i];
+    if (!IsBoxNear(vehicle.s, vehicle.v, vehicle.a / 2, vehicle.d, 0, duration, min_s, max_s, min_d, max_d)) {
+      continue;
+    }
+
+    candidates_.push_back(i);
+    candidate_s_.push_back(vehicle.s);
+    candidate_v_.push_back(vehicle.v);
+    candidate_half_a_.push_back(vehicle.a / 2);
+    candidate_stop_t_.push_back(Vehicle::moving_time(vehicle.v, vehicle.a, duration));
+    candidate_d_.push_back(vehicle.d);
+  }
+
+  const int candidates_count = candidates_.size();
+  if (candidates_count == 0) {
+    return -1;
+  }
+
+  //slices in time order, so first slice with a hit has first collision
+  for (int first_point = 0; first_point < points_count; first_point += SLICE_SIZE) {
+    const int end_point = min(first_point + SLICE_SIZE, points_count);
+
+    //bounding box of ego vehicle in this slice
+    double slice_min_s = s_values[first_point];
+    double slice_max_s = s_values[first_point];
+    double slice_min_d = d_values[first_point];
+    double slice_max_d = d_values[first_point];
+    for (int i = first_point + 1; i < end_point; ++i) {
+      slice_min_s = min(slice_min_s, s_values[i]);
+      slice_max_s = max(slice_max_s, s_values[i]);
+      slice_min_d = min(slice_min_d, d_values[i]);
+      slice_max_d = max(slice_max_d, d_values[i]);
+    }
+
+    //same box test within this slice only, most candidates are far away
+    //from ego vehicle during most slices
+    slice_candidates_.clear();
+    for (int j = 0; j < candidates_count; ++j) {
+      if (IsBoxNear(candidate_s_[j], candidate_v_[j], candidate_half_a_[j], candidate_d_[j], first_point * 0.02,
+                    (end_point - 1) * 0.02, slice_min_s, slice_max_s, slice_min_d, slice_max_d)) {
+        slice_candidates_.push_back(j);
+      }
+    }
+    if (slice_candidates_.empty()) {
+      continue;
+    }
+
+    //blocks of slice in time order, same as slices
+    const int full_blocks_end = end_point - (end_point - first_point) % BLOCK_SIZE;
+    for (int block_point = first_point; block_point < full_blocks_end; block_point += BLOCK_SIZE) {
+      for (int i = 0; i < slice_candidates_.size(); ++i) {
+        if (IsBlockColliding(s_values, d_values, block_point, slice_candidates_[i])) {
+          //another candidate may hit earlier within this block
+          return FindFirstCollisionInRange(s_values, d_values, block_point, block_point + BLOCK_SIZE, vehicle_index);
+        }
+      }
+    }
+
+    //remaining points of last slice which don't fill a block
+    int collision_point = FindFirstCollisionInRange(s_values, d_values, full_blocks_end, end_point, vehicle_index);
+    if (collision_point != -1) {
+      return collision_point;
+    }
+  }
+
+  return -1;
+}
+
+bool CollisionChecker::IsBoxNear(double s,
+                                 double v,
+                                 double half_a,
+                                 double d,
+                                 double start_t,
+                                 double end_t,
+                                 double min_s,
+                                 double max_s,
+                                 double min_d,
+                                 double max_d) const {
+  if (d < min_d - collision_distance_ || d > max_d + collision_distance_) {
+    return false;
+  }
+
+  //with acceleration vehicle can go past ends of its s range and
+  //come back, by at most |a| * duration^2 / 8. Braking vehicle
+  //stops like in Vehicle::s_at
+  double start_moving_t = Vehicle::moving_time(v, 2 * half_a, start_t);
+  double end_moving_t = Vehicle::moving_time(v, 2 * half_a, end_t);
+  double start_s = s + (v + half_a * start_moving_t) * start_moving_t;
+  double end_s = s + (v + half_a * end_moving_t) * end_moving_t;
+  double slack = fabs(half_a) * (end_t - start_t) * (end_t - start_t) / 4;
+  return max(start_s, end_s) + slack >= min_s - collision_distance_
+      && min(start_s, end_s) - slack <= max_s + collision_distance_;
+}
+
+int CollisionChecker::FindFirstCollisionInRange(const double *s_values,
+                                                const double *d_values,
+                                                int from_point,
+                                                int to_point,
+                                                int &vehicle_index) const {
+  //only candidates of current slice can collide in it
+  const int slice_candidates_count = slice_candidates_.size();
+  for (int i = from_point; i < to_point; ++i) {
+    double t = i * 0.02;
+    for (int k = 0; k < slice_candidates_count; ++k) {
+      int j = slice_candidates_[k];
+      double moving_t = min(t, candidate_stop_t_[j]);
+      double delta_s = candidate_s_[j] + (candidate_v_[j] + candidate_half_a_[j] * moving_t) * moving_t - s_values[i];
+      double delta_d = candidate_d_[j] - d_values[i];
+      if (delta_s * delta_s + delta_d * delta_d < collision_distance_ * collision_distance_) {
+        vehicle_index = candidates_[j];
+        return i;
+      }
+    }
+  }
+
+  return -1;
+}
@@ -0,0 +1,96 @@
+/*
+ * collision_checker.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef COLLISION_CHECKER_H_
+#define COLLISION_CHECKER_H_
+
+#include <vector>
+#include "Eigen/Dense"
+#include "vehicle.h"
+#include "trajectory.h"
+
+using namespace std;
+
+/**
+ * Checks whether footprint of ego vehicle along a trajectory overlaps footprint
+ * of any predicted vehicle. Vehicles are modeled as circles in (s, d), so
+ * unlike lane based checks it sees lateral movement of lane changes.
+ *
+ * Search goes from coarse to fine. Vehicles whose bounding box over whole
+ * trajectory (s range over time and d) can't touch that of ego vehicle are
+ * dropped first. Then for each slice of SLICE_SIZE points same test is done
+ * with bounding boxes of that slice only, and just the vehicles which pass
+ * it are checked against blocks of BLOCK_SIZE points of the slice at once
+ * with Eigen fixed size arrays, which are SIMD vectorized. Boxes are
+ * conservative so result is same as checking every point against every
+ * vehicle. Slices and blocks are checked in time order so search stops at
+ * first block with a hit.
+ */
+class CollisionChecker {
+public:
+  CollisionChecker(double vehicle_radius);
+  virtual ~CollisionChecker();
+
+  /**
+   * Point i of trajectory is at time i * 0.02
+   * @param vehicle_index  set to index of colliding vehicle if there is a collision
+   * @returns index of first trajectory point at which footprints overlap or -1
+   */
+  int FindFirstCollision(const vector<Vehicle> &vehicles, const FrenetTrajectory &trajectory, int &vehicle_index);
+
+private:
+  static const int BLOCK_SIZE = 8;
+  //has to be a multiple of BLOCK_SIZE so that blocks don't cross slices
+  static const int SLICE_SIZE = 2 * BLOCK_SIZE;
+  typedef Eigen::Array<double, BLOCK_SIZE, 1> Block;
+
+  /**
+   * @returns false if vehicle at (s, d) moving with v and 2 * half_a can't come
+   * within collision distance of box [min_s, max_s] x [min_d, max_d] between
+   * start_t and end_t
+   */
+  bool IsBoxNear(double s,
+                 double v,
+                 double half_a,
+                 double d,
+                 double start_t,
+                 double end_t,
+                 double min_s,
+                 double max_s,
+                 double min_d,
+                 double max_d) const;
+
+  /**
+   * @returns true if a candidate's footprint overlaps ego footprint at a point in block
+   */
+  bool IsBlockColliding(const double *s_values, const double *d_values, int first_point, int candidate) const;
+
+  /**
+   * Scalar check of points in [from_point, to_point) against candidates of current slice
+   */
+  int FindFirstCollisionInRange(const double *s_values,
+                                const double *d_values,
+                                int from_point,
+                                int to_point,
+                                int &vehicle_index) const;
+
+  //circles of both vehicles overlap when centers are closer than this
+  const double collision_distance_;
+
+  //vehicles left after bounding box test, as structure of arrays
+  vector<int> candidates_;
+  vector<double> candidate_s_;
+  vector<double> candidate_v_;
+  vector<double> candidate_half_a_;
+  //time candidate stops at, or whole trajectory duration if it doesn't
+  vector<double> candidate_stop_t_;
+  vector<double> candidate_d_;
+  //positions in candidates_ of those near ego vehicle in current slice
+  vector<int> slice_candidates_;
+};
+
+#endif /* COLLISION_CHECKER_H_ */
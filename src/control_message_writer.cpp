@@ -0,0 +1,141 @@
+/*
+ * control_message_writer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "control_message_writer.h"
+
+ControlMessageWriter::ControlMessageWriter(int capacity) {
+  this->points_.resize(capacity);
+  this->head_ = 0;
+  this->size_ = 0;
+}
+
+ControlMessageWriter::~ControlMessageWriter() {
+}
+
+const string &ControlMessageWriter::Write(const CartesianTrajectory &trajectory) {
+  const int points_count = trajectory.x_values.size();
+  if (points_count > points_.size()) {
+    //only happens for paths longer than buffer, start over with a bigger one
+    points_.resize(points_count);
+    head_ = 0;
+    size_ = 0;
+  }
+
+  //carried over points already have their text,
+  //format the rest and add them to buffer
+  const int reused_count = Align(trajectory);
+  for (int i = reused_count; i < points_count; ++i) {
+    Append(trajectory.x_values[i], trajectory.y_values[i]);
+  }
+
+  message_.clear();
+  message_.append("42[\"control\",{\"next_x\":[");
+  for (int i = 0; i < points_count; ++i) {
+    if (i > 0) {
+      message_.push_back(',');
+    }
+    const FormattedPoint &point = PointAt(i);
+    message_.append(point.x_text, point.x_length);
+  }
+  message_.append("],\"next_y\":[");
+  for (int i = 0; i < points_count; ++i) {
+    if (i > 0) {
+      message_.push_back(',');
+    }
+    const FormattedPoint &point = PointAt(i);
+    message_.append(point.y_text, point.y_length);
+  }
+  message_.append("]}]");
+
+  return message_;
+}
+
+int ControlMessageWriter::Align(const CartesianTrajectory &trajectory) {
+  const int points_count = trajectory.x_values.size();
+  if (points_count == 0) {
+    size_ = 0;
+    return 0;
+  }
+
+  //previous path is either parsed from text we sent or taken from our
+  //record of sent path, so its values are exactly those read back from
+  //our text or those we wrote. Find where it starts in buffer, points
+  //before that one have been traversed by Simulator
+  double first_x = trajectory.x_values[0];
+  double first_y = trajectory.y_values[0];
+  int consumed_count = 0;
+  while (consumed_count < size_ && !IsSamePoint(PointAt(consumed_count), first_x, first_y)) {
+    ++consumed_count;
+  }
+  head_ = (head_ + consumed_count) % points_.size();
+  size_ -= consumed_count;
+
+  //text can be reused as long as trajectory follows buffer, everything
+  //after that was sent last time but has been replaced by new points
+  int carried_count = 0;
+  while (carried_count < size_ && carried_count < points_count
+      && IsSamePoint(PointAt(carried_count), trajectory.x_values[carried_count], trajectory.y_values[carried_count])) {
+    ++carried_count;
+  }
+  size_ = carried_count;
+
+  return carried_count;
+}
+
+void ControlMessageWriter::Append(double x, double y) {
+  const int capacity = points_.size();
+  int tail = (head_ + size_) % capacity;
+
+  FormattedPoint &point = points_[tail];
+  point.x = x;
+  point.y = y;
+  point.x_length = FormatValue(x, point.x_text);
+  point.y_length = FormatValue(y, point.y_text);
+  point.read_x = isfinite(x) ? strtod(point.x_text, NULL) : NAN;
+  point.read_y = isfinite(y) ? strtod(point.y_text, NULL) : NAN;
+
+  if (size_ < capacity) {
+    ++size_;
+  } else {
+    //buffer is full, oldest point got overwritten
+    head_ = (head_ + 1) % capacity;
+  }
+}
+
+int ControlMessageWriter::FormatValue(double value, char *text) {
+  //json writes infinity and NAN as null
+  if (!isfinite(value)) {
+    strcpy(text, "null");
+    return 4;
+  }
+  if (value == 0) {
+    strcpy(text, signbit(value) ? "-0.0" : "0.0");
+    return signbit(value) ? 4 : 3;
+  }
+
+  int length = snprintf(text, sizeof(FormattedPoint::x_text), "%.15g", value);
+
+  //json keeps a value looking like a floating point number
+  if (strpbrk(text, ".eE") == NULL) {
+    strcpy(text + length, ".0");
+    length += 2;
+  }
+
+  return length;
+}
+
+bool ControlMessageWriter::IsSamePoint(const FormattedPoint &point, double x, double y) const {
+  return (point.x == x && point.y == y) || (point.read_x == x && point.read_y == y);
+}
+
+FormattedPoint &ControlMessageWriter::PointAt(int i) {
+  return points_[(head_ + i) % points_.size()];
+}
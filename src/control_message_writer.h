@@ -0,0 +1,81 @@
+/*
+ * control_message_writer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef CONTROL_MESSAGE_WRITER_H_
+#define CONTROL_MESSAGE_WRITER_H_
+
+#include <string>
+#include <vector>
+#include "trajectory.h"
+
+using namespace std;
+
+/**
+ * Text of a path point as written in control message, together with its
+ * values and the values Simulator will read back from that text
+ */
+struct FormattedPoint {
+  double x;
+  double y;
+  double read_x;
+  double read_y;
+  char x_text[32];
+  char y_text[32];
+  int x_length;
+  int y_length;
+};
+
+/**
+ * Writes control messages for Simulator. Most points of a path are the not
+ * yet traversed part of last path which Simulator returned as previous path,
+ * so text of emitted points is kept in a ring buffer and reused for these,
+ * only newly generated points are formatted. Message text is the same as
+ * json dump of next_x and next_y would give.
+ */
+class ControlMessageWriter {
+public:
+  explicit ControlMessageWriter(int capacity = 128);
+  virtual ~ControlMessageWriter();
+
+  /**
+   * @returns 42["control",{"next_x":[...],"next_y":[...]}] message,
+   * valid until next call
+   */
+  const string &Write(const CartesianTrajectory &trajectory);
+
+private:
+  /**
+   * Drops points Simulator has traversed from front of buffer and points
+   * that are not part of trajectory anymore from its end
+   * @returns number of points at start of trajectory which are in buffer
+   */
+  int Align(const CartesianTrajectory &trajectory);
+
+  void Append(double x, double y);
+
+  /**
+   * @returns true if values are the ones point was written from or
+   * the ones read back from its text, text of both is the same
+   */
+  bool IsSamePoint(const FormattedPoint &point, double x, double y) const;
+
+  /**
+   * Formats value like json does (15 significant digits)
+   * @returns length of text
+   */
+  static int FormatValue(double value, char *text);
+
+  FormattedPoint &PointAt(int i);
+
+  vector<FormattedPoint> points_;
+  int head_;
+  int size_;
+  //kept between calls so it keeps its capacity
+  string message_;
+};
+
+#endif /* CONTROL_MESSAGE_WRITER_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include <math.h>
+#include <algorithm>
 #include "cost_functions.h"
 #include "map_utils.h"
 
@@ -13,7 +14,8 @@ CostFunctions::~CostFunctions() {
 
 }
 
-CostFunctions::CostFunctions() {
+CostFunctions::CostFunctions()
+    : collision_checker_(VEHICLE_RADIUS) {
 
 }
 
@@ -24,6 +26,13 @@ double CostFunctions::CalculateCost(const Vehicle &ego_vehicle,
   //convert to FrenetTrajectory
   FrenetTrajectory frenet_trajectory = MapUtils::CartesianToFrenet(trajectory, ego_vehicle.yaw);
 
+  return CalculateCost(ego_vehicle, vehicles, frenet_trajectory, current_lane);
+}
+
+double CostFunctions::CalculateCost(const Vehicle &ego_vehicle,
+                                    const vector<Vehicle> &vehicles,
+                                    const FrenetTrajectory &frenet_trajectory,
+                                    const int current_lane) {
   double total_cost = 0.0;
 
   for (int i = 0; i < cost_functions_.size(); ++i) {
@@ -37,40 +46,141 @@ double CostFunctions::CalculateCost(const Vehicle &ego_vehicle,
   return total_cost;
 }
 
-vector<double> CostFunctions::FindNearestApproachDuringTrajectory(const vector<Vehicle>& vehicles,
+NearestApproach CostFunctions::FindNearestApproachDuringTrajectory(const vector<Vehicle>& vehicles,
                                                           const FrenetTrajectory& trajectory,
                                                           bool consider_only_leading_vehicles) {
 
-  //for each point in trajectory predict where other vehicle
-  //will be at that point in time to see if there is a collision
+  //ego vehicle moves linearly between trajectory points (0.02 secs apart)
+  //and other vehicles move with constant acceleration, so on each segment
+  //the gap between them is a quadratic in time and its minimum can be
+  //found exactly instead of only checking at trajectory points
   const int num_timesteps = trajectory.s_values.size();
   double timestep = 0.02; //each point is 0.02 (20 ms) timesteps away from other
 
+  //we are only interested in vehicles in trajectory's lane
+  lane_vehicles_.clear();
+  const int vehicles_count = vehicles.size();
+  for (int i = 0; i < vehicles_count; ++i) {
+    if (vehicles[i].lane == trajectory.lane) {
+      lane_vehicles_.push_back(i);
+    }
+  }
+
   double min_distance = 999999;
   int nearest_vehicle_index = -1;
   double min_distance_ego_vehicle_s = -1;
   double time_of_appraoch = BUFFER_DISTANCE/ 0.02;
-  int timesteps = 0;
-  for (int i = 0; i < num_timesteps; ++i) {
-    double s = trajectory.s_values[i];
-    double d = trajectory.d_values[i];
 
-    //calculate time at this point in trajectory
-    double delta_t = (i) * timestep;
-    int vehicle_index = FindMinimumDistanceVehicleIndex(vehicles, s,
-        trajectory.lane, delta_t, consider_only_leading_vehicles);
+  const int lane_vehicles_count = lane_vehicles_.size();
+  //a single point trajectory is a segment of zero duration
+  const int segments_count = max(num_timesteps - 1, 1);
+  for (int i = 0; i < segments_count && num_timesteps > 0; ++i) {
+    double start_t = i * timestep;
+    double start_s = trajectory.s_values[i];
+    double duration = num_timesteps > 1 ? timestep : 0;
+    double ego_v = num_timesteps > 1 ? (trajectory.s_values[i + 1] - start_s) / timestep : 0;
+
+    for (int j = 0; j < lane_vehicles_count; ++j) {
+      const Vehicle &vehicle = vehicles[lane_vehicles_[j]];
+
+      //gap(tau) = gap + relative_v * tau + half_a * tau^2 where tau is time since start of segment
+      double gap = vehicle.s_at(start_t) - start_s;
+      double relative_v = vehicle.v_at(start_t) - ego_v;
+      //vehicle which has stopped stays there, one which stops during
+      //this segment backs up less than a millimeter by its end
+      double half_a = vehicle.v_at(start_t) > 0 || vehicle.a > 0 ? vehicle.a / 2 : 0;
+
+      double distance;
+      double tau;
+      if (!FindSegmentNearestApproach(gap, relative_v, half_a, duration,
+                                      consider_only_leading_vehicles, distance, tau)) {
+        continue;
+      }
+
+      //on equal distance earlier approach wins, so for distance 0
+      //time of approach is time to collision
+      double t = start_t + tau;
+      if (distance < min_distance
+          || (distance == min_distance && t < time_of_appraoch)) {
+        min_distance = distance;
+        nearest_vehicle_index = lane_vehicles_[j];
+        min_distance_ego_vehicle_s = start_s + ego_v * tau;
+        time_of_appraoch = t;
+      }
+    }
+  }
+  printf("For lane %d, found nearest approach %f at time %f and timesteps %f\n", trajectory.lane, min_distance, time_of_appraoch, time_of_appraoch / timestep);
+  NearestApproach nearest_approach;
+  nearest_approach.distance = min_distance;
+  nearest_approach.ego_vehicle_s = min_distance_ego_vehicle_s;
+  nearest_approach.vehicle_index = nearest_vehicle_index;
+  nearest_approach.time = time_of_appraoch;
+
+  return nearest_approach;
+}
 
-    double distance = vehicle_index != -1 ? abs(vehicles[vehicle_index].s - s) : 9999999;
-    if (distance < min_distance) {
-      min_distance = distance;
-      nearest_vehicle_index = vehicle_index;
-      min_distance_ego_vehicle_s = s;
-      time_of_appraoch = delta_t;
-      timesteps = i;
+bool CostFunctions::FindSegmentNearestApproach(double gap,
+                                               double relative_v,
+                                               double half_a,
+                                               double duration,
+                                               bool consider_only_leading_vehicles,
+                                               double &distance,
+                                               double &tau) {
+  //earliest time in [0, duration] at which gap becomes 0 (vehicles touch)
+  double root = -1;
+  if (gap == 0) {
+    root = 0;
+  } else if (half_a == 0) {
+    if (relative_v != 0) {
+      root = -gap / relative_v;
     }
+  } else {
+    double discriminant = relative_v * relative_v - 4 * half_a * gap;
+    if (discriminant >= 0) {
+      double sqrt_discriminant = sqrt(discriminant);
+      double root1 = (-relative_v - sqrt_discriminant) / (2 * half_a);
+      double root2 = (-relative_v + sqrt_discriminant) / (2 * half_a);
+      root = min(root1, root2);
+      if (root < 0) {
+        root = max(root1, root2);
+      }
+    }
+  }
+
+  if (root >= 0 && root <= duration) {
+    distance = 0;
+    tau = root;
+    return true;
+  }
+
+  //gap keeps its sign during whole segment, vehicle
+  //is either behind or ahead of ego vehicle all the time
+  if (gap < 0 && consider_only_leading_vehicles) {
+    return false;
   }
-  printf("For lane %d, found nearest approach %f at time %f and timesteps %d\n", trajectory.lane, min_distance, time_of_appraoch, timesteps);
-  return {min_distance, min_distance_ego_vehicle_s, double(nearest_vehicle_index), time_of_appraoch};
+
+  //minimum of |gap| is at one of segment ends or at vertex of parabola
+  distance = fabs(gap);
+  tau = 0;
+
+  double end_distance = fabs(gap + relative_v * duration + half_a * duration * duration);
+  if (end_distance < distance) {
+    distance = end_distance;
+    tau = duration;
+  }
+
+  if (half_a != 0) {
+    double vertex = -relative_v / (2 * half_a);
+    if (vertex > 0 && vertex < duration) {
+      double vertex_distance = fabs(gap + relative_v * vertex + half_a * vertex * vertex);
+      if (vertex_distance < distance) {
+        distance = vertex_distance;
+        tau = vertex;
+      }
+    }
+  }
+
+  return true;
 }
 
 int CostFunctions::FindMinimumDistanceVehicleIndex(const vector<Vehicle> &vehicles,
@@ -90,7 +200,7 @@ int CostFunctions::FindMinimumDistanceVehicleIndex(const vector<Vehicle> &vehicl
     }
 
     //predict vehicle state at time delta_t
-    double other_vehicle_predicted_s = vehicles[i].state_at(delta_t)[1];
+    double other_vehicle_predicted_s = vehicles[i].s_at(delta_t);
 
     //we only care about leading vehicles
     if (other_vehicle_predicted_s < ego_vehicle_s
@@ -109,34 +219,66 @@ int CostFunctions::FindMinimumDistanceVehicleIndex(const vector<Vehicle> &vehicl
 }
 
 
+void CostFunctions::BeginCycle() {
+  ++cycle_;
+}
+
+void CostFunctions::BuildOccupancyGrid(const vector<Vehicle> &vehicles, double ego_vehicle_s) {
+  occupancy_grid_.Build(vehicles, ego_vehicle_s, COLLISION_DISTANCE);
+  occupancy_grid_cycle_ = cycle_;
+}
+
+void CostFunctions::BuildGapIndex(const vector<Vehicle> &vehicles) {
+  gap_index_.Build(vehicles);
+  gap_index_cycle_ = cycle_;
+}
+
+const GapIndex &CostFunctions::GetGapIndex() const {
+  return gap_index_;
+}
+
 double CostFunctions::CollisionCost(const Vehicle &ego_vehicle,
                                     const vector<Vehicle> &vehicles,
                                     const FrenetTrajectory &trajectory,
                                     const int current_lane) {
 
+  //footprints overlapping at any point, in any lane trajectory goes through, is
+  //a collision for sure. Checks below only look at trajectory's lane and s
+  int colliding_vehicle_index;
+  int collision_point = collision_checker_.FindFirstCollision(vehicles, trajectory, colliding_vehicle_index);
+  if (collision_point != -1) {
+    printf("Footprint collision with vehicle %d at timesteps %d\n", colliding_vehicle_index, collision_point);
+    return 1.0;
+  }
+
+  //if trajectory does not pass through an occupied cell then no vehicle
+  //comes within COLLISION_DISTANCE and there is nothing more to check
+  if (occupancy_grid_cycle_ == cycle_
+      && !occupancy_grid_.IsTrajectoryOccupied(trajectory, trajectory.lane)) {
+    return 0.0;
+  }
+
   //for each point in trajectory predict where other vehicle
   //will be at that point in time to see if there is a collision
-  vector<double> nearest_approach = FindNearestApproachDuringTrajectory(vehicles,
+  NearestApproach nearest_approach = FindNearestApproachDuringTrajectory(vehicles,
       trajectory, false);
 
-  double distance = nearest_approach[0];
-  double ego_vehicle_s_at_time = nearest_approach[1];
-  double vehicle_index = nearest_approach[2];
-  double time_of_approach = nearest_approach[3];
+  double distance = nearest_approach.distance;
+  double ego_vehicle_s_at_time = nearest_approach.ego_vehicle_s;
+  int vehicle_index = nearest_approach.vehicle_index;
+  double time_of_approach = nearest_approach.time;
 
   if (distance > COLLISION_DISTANCE) {
     return 0.0;
   }
 
-  cout << "nearest_approach(distance, s, vehicle index, time: " << endl;
-  Utils::print_vector(nearest_approach);
+  printf("nearest_approach(distance, s, vehicle index, time): %f,%f,%d,%f\n", distance,
+         ego_vehicle_s_at_time, vehicle_index, time_of_approach);
 
-  Vehicle other_vehicle = vehicles[vehicle_index];
+  const Vehicle &other_vehicle = vehicles[vehicle_index];
 
-  //returns = [lane, s, v, a]
-  vector<double> other_vehicle_state_at_time = other_vehicle.state_at(time_of_approach);
-  double other_vehicle_s = other_vehicle_state_at_time[1];
-  double other_vehicle_v = other_vehicle_state_at_time[2];
+  double other_vehicle_s = other_vehicle.s_at(time_of_approach);
+  double other_vehicle_v = other_vehicle.v_at(time_of_approach);
 
   if (trajectory.lane == current_lane) {
     return 0.0;
@@ -170,13 +312,16 @@ double CostFunctions::BufferCost(const Vehicle &ego_vehicle,
 
   double delta_t = trajectory.s_values.size() * 0.02;
   double end_s = trajectory.s_values[trajectory.s_values.size()-1];
-  int index = FindMinimumDistanceVehicleIndex(vehicles, end_s,
-      trajectory.lane, delta_t, true);
+  //nearest leading vehicle is leader of gap that contains end_s,
+  //scan only if index was not built this cycle
+  int index = gap_index_cycle_ == cycle_
+      ? gap_index_.FindGap(trajectory.lane, end_s, delta_t).leader_index
+      : FindMinimumDistanceVehicleIndex(vehicles, end_s, trajectory.lane, delta_t, true);
 
   if (index == -1) {
     return 0.0;
   }
-  double distance = vehicles[index].state_at(delta_t)[1] - end_s;
+  double distance = vehicles[index].s_at(delta_t) - end_s;
 
 //  if (distance > BUFFER_DISTANCE) {
 //    return 0.0;
@@ -14,9 +14,22 @@
 #include "trajectory.h"
 #include "vehicle.h"
 #include "utils.h"
+#include "occupancy_grid.h"
+#include "collision_checker.h"
+#include "gap_index.h"
 
 using namespace std;
 
+/**
+ * Result of nearest approach search, time is in seconds from start of trajectory
+ */
+struct NearestApproach {
+  double distance;
+  double ego_vehicle_s;
+  int vehicle_index;
+  double time;
+};
+
 class CostFunctions {
 public:
   virtual ~CostFunctions();
@@ -26,6 +39,31 @@ public:
                        const vector<Vehicle> &vehicles,
                        const CartesianTrajectory &trajectory,
                        const int current_lane);
+  /**
+   * Same as above for a trajectory that is already converted to Frenet
+   */
+  double CalculateCost(const Vehicle &ego_vehicle,
+                       const vector<Vehicle> &vehicles,
+                       const FrenetTrajectory &frenet_trajectory,
+                       const int current_lane);
+  /**
+   * Has to be called at start of every cycle. Occupancy grid and gap
+   * index are only used in cycle they were built in, so costs of that
+   * cycle must be calculated for same vehicles they were built for
+   */
+  void BeginCycle();
+  /**
+   * Builds occupancy grid of predicted vehicles used to skip collision
+   * checks, has to be called every cycle before costs are calculated
+   */
+  void BuildOccupancyGrid(const vector<Vehicle> &vehicles, double ego_vehicle_s);
+  /**
+   * Builds gap index of vehicles used to find vehicle ahead in a lane,
+   * has to be called every cycle before costs are calculated
+   */
+  void BuildGapIndex(const vector<Vehicle> &vehicles);
+  const GapIndex &GetGapIndex() const;
+
   double CollisionCost(const Vehicle &ego_vehicle,
                        const vector<Vehicle> &vehicles,
                        const FrenetTrajectory &trajectory,
@@ -52,16 +90,50 @@ private:
   const double GOAL_S = 6945.554;
   const double VEHICLE_RADIUS = 1.5;
 
+  //footprints of VEHICLE_RADIUS in (s, d)
+  CollisionChecker collision_checker_;
+
+  //counted up by BeginCycle()
+  long cycle_ = 0;
+
+  //inflated by COLLISION_DISTANCE, only used in cycle it was built in
+  OccupancyGrid occupancy_grid_;
+  long occupancy_grid_cycle_ = -1;
+
+  //vehicles of each lane ordered by s, only used in cycle it was built in
+  GapIndex gap_index_;
+  long gap_index_cycle_ = -1;
+
   //define a typdef for function pointer
   typedef double (CostFunctions::*cost_function_ptr)(
       const Vehicle &ego_vehicle, const vector<Vehicle> &vehicles,
       const FrenetTrajectory &trajectory,
       const int current_lane);
 
-  vector<double> FindNearestApproachDuringTrajectory(
+  /**
+   * Finds closest approach of any vehicle in trajectory's lane, exact for ego vehicle
+   * moving linearly between trajectory points and other vehicles moving with constant
+   * acceleration. If distance is 0, time is time to collision.
+   */
+  NearestApproach FindNearestApproachDuringTrajectory(
       const vector<Vehicle>& vehicles, const FrenetTrajectory& trajectory,
       bool consider_only_leading_vehicles);
 
+  /**
+   * Minimum of |gap + relative_v * tau + half_a * tau^2| for tau in [0, duration]
+   * @returns false if only leading vehicles are considered and vehicle stays behind
+   */
+  static bool FindSegmentNearestApproach(double gap,
+                                         double relative_v,
+                                         double half_a,
+                                         double duration,
+                                         bool consider_only_leading_vehicles,
+                                         double &distance,
+                                         double &tau);
+
+  //indexes of vehicles in lane being checked, kept to reuse its capacity
+  vector<int> lane_vehicles_;
+
   const vector<cost_function_ptr> cost_functions_ = {
       &CostFunctions::CollisionCost,
       &CostFunctions::BufferCost,
@@ -0,0 +1,68 @@
+/*
+ * feasibility_validator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "Eigen/Dense"
+#include "constants.h"
+#include "feasibility_validator.h"
+
+FeasibilityValidator::FeasibilityValidator()
+    : MAX_SPEED(Constants::SPEED_LIMIT * 1609.34 / 3600),
+      MAX_ACCELERATION(Constants::MAX_ACCELERATION),
+      MAX_JERK(Constants::MAX_JERK) {
+}
+
+FeasibilityValidator::~FeasibilityValidator() {
+}
+
+Feasibility FeasibilityValidator::Validate(const CartesianTrajectory &trajectory, int first_point) const {
+  first_point = max(0, first_point);
+  const int points_count = max(0, int(trajectory.x_values.size()) - first_point);
+  Eigen::Map<const Eigen::ArrayXd> x(trajectory.x_values.data() + first_point, points_count);
+  Eigen::Map<const Eigen::ArrayXd> y(trajectory.y_values.data() + first_point, points_count);
+
+  //maxima are found on squared values, only they are square rooted
+  double max_distance = 0;
+  if (points_count >= 2) {
+    const int n = points_count - 1;
+    max_distance = ((x.tail(n) - x.head(n)).square() + (y.tail(n) - y.head(n)).square()).maxCoeff();
+  }
+
+  //steps ACCELERATION_WINDOW points apart differ by change of velocity over window
+  const int w = ACCELERATION_WINDOW;
+  double max_velocity_change = 0;
+  if (points_count >= w + 2) {
+    const int n = points_count - w - 1;
+    max_velocity_change = ((x.segment(w + 1, n) - x.segment(w, n) - x.segment(1, n) + x.head(n)).square()
+        + (y.segment(w + 1, n) - y.segment(w, n) - y.segment(1, n) + y.head(n)).square()).maxCoeff();
+  }
+
+  //and those changes JERK_WINDOW points apart differ by change of acceleration
+  const int l = JERK_WINDOW;
+  double max_acceleration_change = 0;
+  if (points_count >= w + l + 2) {
+    const int n = points_count - w - l - 1;
+    max_acceleration_change = ((x.segment(w + l + 1, n) - x.segment(w + l, n) - x.segment(l + 1, n) + x.segment(l, n)
+        - x.segment(w + 1, n) + x.segment(w, n) + x.segment(1, n) - x.head(n)).square()
+        + (y.segment(w + l + 1, n) - y.segment(w + l, n) - y.segment(l + 1, n) + y.segment(l, n)
+            - y.segment(w + 1, n) + y.segment(w, n) + y.segment(1, n) - y.head(n)).square()).maxCoeff();
+  }
+
+  const double dt = 0.02;
+  const double acceleration_window_duration = ACCELERATION_WINDOW * dt;
+  const double jerk_window_duration = JERK_WINDOW * dt;
+  Feasibility feasibility;
+  feasibility.max_speed = sqrt(max_distance) / dt;
+  feasibility.max_acceleration = sqrt(max_velocity_change) / (dt * acceleration_window_duration);
+  feasibility.max_jerk = sqrt(max_acceleration_change) / (dt * acceleration_window_duration * jerk_window_duration);
+  feasibility.is_speed_exceeded = feasibility.max_speed > MAX_SPEED;
+  feasibility.is_acceleration_exceeded = feasibility.max_acceleration > MAX_ACCELERATION;
+  feasibility.is_jerk_exceeded = feasibility.max_jerk > MAX_JERK;
+
+  return feasibility;
+}
@@ -0,0 +1,66 @@
+/*
+ * feasibility_validator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef FEASIBILITY_VALIDATOR_H_
+#define FEASIBILITY_VALIDATOR_H_
+
+#include "trajectory.h"
+
+using namespace std;
+
+/**
+ * Largest speed (m/s), acceleration (m/s^2) and jerk (m/s^3) found on a
+ * trajectory and which of them is over its limit
+ */
+struct Feasibility {
+  double max_speed;
+  double max_acceleration;
+  double max_jerk;
+  bool is_speed_exceeded;
+  bool is_acceleration_exceeded;
+  bool is_jerk_exceeded;
+
+  bool IsFeasible() const {
+    return !is_speed_exceeded && !is_acceleration_exceeded && !is_jerk_exceeded;
+  }
+};
+
+/**
+ * Checks a cartesian trajectory against limits in constants.h with finite
+ * differences of points 0.02 secs apart: speed from steps between points,
+ * acceleration from change of step over a window and jerk from change of
+ * that acceleration over a longer window. Differences are
+ * Eigen array expressions over mapped x and y values so each maximum is
+ * a single vectorized pass without temporaries.
+ */
+class FeasibilityValidator {
+public:
+  FeasibilityValidator();
+  virtual ~FeasibilityValidator();
+
+  /**
+   * @param first_point  points before it are not checked, e.g. points already
+   * sent to Simulator which no candidate can change
+   */
+  Feasibility Validate(const CartesianTrajectory &trajectory, int first_point = 0) const;
+
+  //acceleration is averaged over this many points (0.2 secs) like Simulator
+  //does and jerk over change of that in JERK_WINDOW points (0.5 secs),
+  //single steps of spline points are far too noisy for both
+  static const int ACCELERATION_WINDOW = 10;
+  static const int JERK_WINDOW = 25;
+  //points needed before first new point so that joint with
+  //previous path is covered by acceleration and jerk windows
+  static const int CONTEXT_POINTS_COUNT = ACCELERATION_WINDOW + JERK_WINDOW + 1;
+
+private:
+  const double MAX_SPEED; // m/s
+  const double MAX_ACCELERATION; // m/s^2
+  const double MAX_JERK; // m/s^3
+};
+
+#endif /* FEASIBILITY_VALIDATOR_H_ */
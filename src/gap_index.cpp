@@ -0,0 +1,195 @@
+/*
+ * gap_index.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "gap_index.h"
+
+namespace {
+//time beyond any planning horizon
+const double NEVER = 1e9;
+}
+
+GapIndex::GapIndex() {
+}
+
+GapIndex::~GapIndex() {
+}
+
+void GapIndex::Build(const vector<Vehicle> &vehicles) {
+  //only lanes that have vehicles in them are indexed, any other lane is empty
+  int lanes_count = 0;
+  const int vehicles_count = vehicles.size();
+  for (int i = 0; i < vehicles_count; ++i) {
+    lanes_count = max(lanes_count, vehicles[i].lane + 1);
+  }
+
+  //bucket vehicles by lane, then sort each lane by s
+  lane_counts_.assign(lanes_count, 0);
+  for (int i = 0; i < vehicles_count; ++i) {
+    if (vehicles[i].lane >= 0) {
+      ++lane_counts_[vehicles[i].lane];
+    }
+  }
+  lane_starts_.assign(lanes_count + 1, 0);
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    lane_starts_[lane + 1] = lane_starts_[lane] + lane_counts_[lane];
+  }
+
+  const int indexed_count = lane_starts_[lanes_count];
+  sorted_indexes_.resize(indexed_count);
+  lane_counts_.assign(lanes_count, 0);
+  for (int i = 0; i < vehicles_count; ++i) {
+    int lane = vehicles[i].lane;
+    if (lane >= 0) {
+      sorted_indexes_[lane_starts_[lane] + lane_counts_[lane]++] = i;
+    }
+  }
+
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    sort(sorted_indexes_.begin() + lane_starts_[lane], sorted_indexes_.begin() + lane_starts_[lane + 1],
+         [&vehicles](int a, int b) {
+           return vehicles[a].s < vehicles[b].s || (vehicles[a].s == vehicles[b].s && a < b);
+         });
+  }
+
+  sorted_s_.resize(indexed_count);
+  sorted_v_.resize(indexed_count);
+  sorted_a_.resize(indexed_count);
+  for (int k = 0; k < indexed_count; ++k) {
+    const Vehicle &vehicle = vehicles[sorted_indexes_[k]];
+    sorted_s_[k] = vehicle.s;
+    sorted_v_[k] = vehicle.v;
+    sorted_a_[k] = vehicle.a;
+  }
+
+  //a lane stays sorted until first follower/leader pair crosses. Crossing
+  //times assume constant acceleration, which only holds until first
+  //vehicle of lane stops, later times are answered with a scan
+  ordered_until_.assign(lanes_count, NEVER);
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    for (int k = lane_starts_[lane]; k < lane_starts_[lane + 1]; ++k) {
+      ordered_until_[lane] = min(ordered_until_[lane], Vehicle::moving_time(sorted_v_[k], sorted_a_[k], NEVER));
+      if (k == lane_starts_[lane]) {
+        continue;
+      }
+      double crossing_time = FindCrossingTime(sorted_s_[k] - sorted_s_[k - 1], sorted_v_[k] - sorted_v_[k - 1],
+                                              (sorted_a_[k] - sorted_a_[k - 1]) / 2);
+      ordered_until_[lane] = min(ordered_until_[lane], crossing_time);
+    }
+  }
+}
+
+double GapIndex::PredictS(int k, double t) const {
+  //same as Vehicle::s_at so that results match a scan of vehicles
+  double moving_t = Vehicle::moving_time(sorted_v_[k], sorted_a_[k], t);
+  return sorted_s_[k] + sorted_v_[k] * moving_t + sorted_a_[k] * moving_t * moving_t / 2;
+}
+
+double GapIndex::PredictV(int k, double t) const {
+  return sorted_v_[k] + sorted_a_[k] * Vehicle::moving_time(sorted_v_[k], sorted_a_[k], t);
+}
+
+double GapIndex::FindCrossingTime(double gap, double relative_v, double half_a) {
+  if (half_a == 0) {
+    return relative_v < 0 ? gap / -relative_v : NEVER;
+  }
+
+  double discriminant = relative_v * relative_v - 4 * half_a * gap;
+  if (discriminant < 0) {
+    //never 0 so it keeps sign of gap, which is not negative
+    return NEVER;
+  }
+
+  //gap is not negative at 0 so first root at or after 0 is where it
+  //can turn negative, for a touching root it only touches 0 which is
+  //reported too, that is just a bit conservative
+  double sqrt_discriminant = sqrt(discriminant);
+  double root1 = (-relative_v - sqrt_discriminant) / (2 * half_a);
+  double root2 = (-relative_v + sqrt_discriminant) / (2 * half_a);
+  double first_root = min(root1, root2);
+  double second_root = max(root1, root2);
+  if (first_root >= 0) {
+    return first_root;
+  }
+  return second_root >= 0 ? second_root : NEVER;
+}
+
+Gap GapIndex::FindGap(int lane, double s, double t) const {
+  Gap gap = { -1, -1, 0, 0, 0, 0 };
+  if (lane < 0 || lane + 1 >= lane_starts_.size()) {
+    return gap;
+  }
+
+  const int lane_start = lane_starts_[lane];
+  const int lane_end = lane_starts_[lane + 1];
+  int leader = -1;
+  int follower = -1;
+  if (t < ordered_until_[lane]) {
+    //predictions are sorted, first one at or ahead of s is leader
+    //and one before it is follower
+    int low = lane_start;
+    int high = lane_end;
+    while (low < high) {
+      int middle = (low + high) / 2;
+      if (PredictS(middle, t) < s) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    leader = low < lane_end ? low : -1;
+    follower = low > lane_start ? low - 1 : -1;
+  } else {
+    //some vehicles have passed each other by t, scan whole lane
+    double leader_s = 0;
+    double follower_s = 0;
+    for (int k = lane_start; k < lane_end; ++k) {
+      double predicted_s = PredictS(k, t);
+      if (predicted_s >= s) {
+        if (leader == -1 || predicted_s < leader_s
+            || (predicted_s == leader_s && sorted_indexes_[k] < sorted_indexes_[leader])) {
+          leader = k;
+          leader_s = predicted_s;
+        }
+      } else if (follower == -1 || predicted_s > follower_s
+          || (predicted_s == follower_s && sorted_indexes_[k] < sorted_indexes_[follower])) {
+        follower = k;
+        follower_s = predicted_s;
+      }
+    }
+  }
+
+  if (leader != -1) {
+    gap.leader_index = sorted_indexes_[leader];
+    gap.leader_s = PredictS(leader, t);
+    gap.leader_v = PredictV(leader, t);
+  }
+  if (follower != -1) {
+    gap.follower_index = sorted_indexes_[follower];
+    gap.follower_s = PredictS(follower, t);
+    gap.follower_v = PredictV(follower, t);
+  }
+
+  return gap;
+}
+
+bool GapIndex::IsGapViable(int lane,
+                           double s,
+                           double t,
+                           double min_distance_behind,
+                           double min_distance_ahead) const {
+  Gap gap = FindGap(lane, s, t);
+  if (gap.leader_index != -1 && gap.leader_s - s < min_distance_ahead) {
+    return false;
+  }
+  if (gap.follower_index != -1 && s - gap.follower_s < min_distance_behind) {
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * gap_index.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef GAP_INDEX_H_
+#define GAP_INDEX_H_
+
+#include <vector>
+#include "vehicle.h"
+
+using namespace std;
+
+/**
+ * Gap between two consecutive vehicles of a lane at some time. Indexes are
+ * into vehicles given to GapIndex::Build(), -1 if there is no vehicle on
+ * that side. Positions and speeds are predicted (Vehicle::s_at, v_at).
+ */
+struct Gap {
+  int follower_index;
+  int leader_index;
+  double follower_s;
+  double leader_s;
+  double follower_v;
+  double leader_v;
+};
+
+/**
+ * Vehicles of each lane sorted by s, built once per cycle. Consecutive
+ * vehicles of a lane form follower/leader pairs and for each pair the
+ * earliest time its predictions cross is recorded. Until first crossing
+ * of a lane predicted s values are still in sorted order, so gap around
+ * any s at such a time is found with a binary search. For later times
+ * the lane is scanned, so answers are always same as scanning vehicles.
+ */
+class GapIndex {
+public:
+  GapIndex();
+  virtual ~GapIndex();
+
+  void Build(const vector<Vehicle> &vehicles);
+
+  /**
+   * @returns gap of lane which contains s at time t, that is vehicle with
+   * smallest predicted s at or ahead of s and one with largest behind it.
+   * On equal s lower vehicle index wins.
+   */
+  Gap FindGap(int lane, double s, double t) const;
+
+  /**
+   * @returns true if no vehicle of lane is within min_distance_behind
+   * behind or min_distance_ahead ahead of s at time t
+   */
+  bool IsGapViable(int lane, double s, double t, double min_distance_behind, double min_distance_ahead) const;
+
+private:
+  /**
+   * @returns predicted s (v) of k-th vehicle of sorted arrays at time t
+   */
+  double PredictS(int k, double t) const;
+  double PredictV(int k, double t) const;
+
+  /**
+   * @returns earliest time at or after 0 at which gap + relative_v * t + half_a * t^2
+   * becomes negative, or a time beyond any horizon if it never does
+   */
+  static double FindCrossingTime(double gap, double relative_v, double half_a);
+
+  //vehicles of lane are at [lane_starts_[lane], lane_starts_[lane + 1]) of sorted arrays
+  vector<int> lane_starts_;
+  vector<int> sorted_indexes_;
+  vector<double> sorted_s_;
+  vector<double> sorted_v_;
+  vector<double> sorted_a_;
+  //predictions of each lane stay in sorted order until this time
+  vector<double> ordered_until_;
+  //vehicles counted per lane while building
+  vector<int> lane_counts_;
+};
+
+#endif /* GAP_INDEX_H_ */
@@ -0,0 +1,126 @@
+/*
+ * jmt_trajectory_generator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <math.h>
+#include "constants.h"
+#include "jmt_trajectory_generator.h"
+
+JMTTrajectoryGenerator::JMTTrajectoryGenerator() {
+}
+
+JMTTrajectoryGenerator::~JMTTrajectoryGenerator() {
+}
+
+const Matrix3d &JMTTrajectoryGenerator::GetInverseTimeMatrix(int timesteps) {
+  map<int, Matrix3d>::iterator iter = inverse_time_matrices_.find(timesteps);
+  if (iter != inverse_time_matrices_.end()) {
+    return iter->second;
+  }
+
+  const double T = timesteps * TIMESTEP;
+  const double T2 = T * T;
+  const double T3 = T2 * T;
+  const double T4 = T3 * T;
+  const double T5 = T4 * T;
+
+  //rows are position, velocity and acceleration at time T
+  //for the a3, a4, a5 terms of the polynomial
+  Matrix3d time_matrix;
+  time_matrix << T3, T4, T5,
+      3 * T2, 4 * T3, 5 * T4,
+      6 * T, 12 * T2, 20 * T3;
+
+  Matrix3d &inverse = inverse_time_matrices_[timesteps];
+  inverse = time_matrix.inverse();
+  return inverse;
+}
+
+void JMTTrajectoryGenerator::JMT(const Vector3d &start, const Vector3d &end, double T, double coefficients[6]) {
+  const int timesteps = max(1, (int) lround(T / TIMESTEP));
+  T = timesteps * TIMESTEP;
+  const double T2 = T * T;
+
+  //first 3 coefficients come directly from start state
+  coefficients[0] = start[0];
+  coefficients[1] = start[1];
+  coefficients[2] = start[2] / 2.0;
+
+  //what is left to reach end state is covered by a3, a4, a5
+  Vector3d remaining;
+  remaining << end[0] - (start[0] + start[1] * T + start[2] * T2 / 2.0),
+      end[1] - (start[1] + start[2] * T),
+      end[2] - start[2];
+
+  Vector3d a = GetInverseTimeMatrix(timesteps) * remaining;
+  coefficients[3] = a[0];
+  coefficients[4] = a[1];
+  coefficients[5] = a[2];
+}
+
+double JMTTrajectoryGenerator::Evaluate(const double coefficients[6], double t) {
+  //Horner's method
+  double value = coefficients[5];
+  for (int i = 4; i >= 0; --i) {
+    value = value * t + coefficients[i];
+  }
+  return value;
+}
+
+FrenetTrajectory JMTTrajectoryGenerator::GenerateTrajectory(const Vector3d &start_s,
+                                                            const Vector3d &start_d,
+                                                            const Vector3d &goal_s,
+                                                            const Vector3d &goal_d,
+                                                            double T,
+                                                            int lane,
+                                                            PlannerWorkspace &workspace) {
+  double s_coefficients[6];
+  double d_coefficients[6];
+  JMT(start_s, goal_s, T, s_coefficients);
+  JMT(start_d, goal_d, T, d_coefficients);
+
+  const int timesteps = max(1, (int) lround(T / TIMESTEP));
+  TrajectoryValues s_values = workspace.MakeVector<double>(timesteps);
+  TrajectoryValues d_values = workspace.MakeVector<double>(timesteps);
+  for (int i = 1; i <= timesteps; ++i) {
+    double t = i * TIMESTEP;
+    s_values.push_back(Evaluate(s_coefficients, t));
+    d_values.push_back(Evaluate(d_coefficients, t));
+  }
+
+  //reference velocity of trajectories is in miles/hour
+  //while goal velocity is in meters/second
+  const double goal_velocity_miles_per_hour = goal_s[1] / (1609.34 / 3600);
+
+  return FrenetTrajectory(std::move(s_values), std::move(d_values), goal_velocity_miles_per_hour, lane);
+}
+
+ArenaVector<FrenetTrajectory> JMTTrajectoryGenerator::GeneratePerturbedTrajectories(const Vector3d &start_s,
+                                                                                   const Vector3d &start_d,
+                                                                                   const Vector3d &goal_s,
+                                                                                   const Vector3d &goal_d,
+                                                                                   double T,
+                                                                                   int lane,
+                                                                                   PlannerWorkspace &workspace) {
+  ArenaVector<FrenetTrajectory> trajectories = workspace.MakeVector<FrenetTrajectory>(Constants::N_SAMPLES + 1);
+  trajectories.push_back(GenerateTrajectory(start_s, start_d, goal_s, goal_d, T, lane, workspace));
+
+  for (int i = 0; i < Constants::N_SAMPLES; ++i) {
+    Vector3d perturbed_s;
+    Vector3d perturbed_d;
+    for (int j = 0; j < 3; ++j) {
+      normal_distribution<double> s_distribution(goal_s[j], Constants::SIGMA_S[j]);
+      normal_distribution<double> d_distribution(goal_d[j], Constants::SIGMA_D[j]);
+      perturbed_s[j] = s_distribution(random_engine_);
+      perturbed_d[j] = d_distribution(random_engine_);
+    }
+
+    trajectories.push_back(GenerateTrajectory(start_s, start_d, perturbed_s, perturbed_d, T, lane, workspace));
+  }
+
+  return trajectories;
+}
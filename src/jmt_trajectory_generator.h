@@ -0,0 +1,83 @@
+/*
+ * jmt_trajectory_generator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef JMT_TRAJECTORY_GENERATOR_H_
+#define JMT_TRAJECTORY_GENERATOR_H_
+
+#include <map>
+#include <random>
+#include "Eigen/Dense"
+#include "trajectory.h"
+#include "planner_workspace.h"
+
+using namespace std;
+using Eigen::Matrix3d;
+using Eigen::Vector3d;
+
+/**
+ * Generates quintic polynomial (Jerk Minimized) trajectories in Frenet
+ * space, s(t) and d(t) are solved separately from start and goal states
+ * [x, x_dot, x_dot_dot].
+ *
+ * Only the 3x3 time matrix of the quintic system depends on horizon T,
+ * its inverse is cached per T so each JMT costs a 3x3 matrix-vector product.
+ * T is rounded to whole timesteps (0.02 secs) so sampled trajectories
+ * end exactly on a point and cache stays small.
+ */
+class JMTTrajectoryGenerator {
+public:
+  JMTTrajectoryGenerator();
+  virtual ~JMTTrajectoryGenerator();
+
+  /**
+   * Calculates coefficients of quintic polynomial
+   * x(t) = a0 + a1*t + a2*t^2 + a3*t^3 + a4*t^4 + a5*t^5
+   * @param coefficients  output, [a0, a1, a2, a3, a4, a5]
+   */
+  void JMT(const Vector3d &start, const Vector3d &end, double T, double coefficients[6]);
+
+  /**
+   * Generates trajectory from start to goal state in T seconds,
+   * one point per timestep starting at t = 0.02
+   */
+  FrenetTrajectory GenerateTrajectory(const Vector3d &start_s,
+                                      const Vector3d &start_d,
+                                      const Vector3d &goal_s,
+                                      const Vector3d &goal_d,
+                                      double T,
+                                      int lane,
+                                      PlannerWorkspace &workspace);
+
+  /**
+   * Generates trajectory for given goal and Constants::N_SAMPLES more
+   * for goals perturbed with Constants::SIGMA_S/SIGMA_D, first one is
+   * always unperturbed goal
+   */
+  ArenaVector<FrenetTrajectory> GeneratePerturbedTrajectories(const Vector3d &start_s,
+                                                              const Vector3d &start_d,
+                                                              const Vector3d &goal_s,
+                                                              const Vector3d &goal_d,
+                                                              double T,
+                                                              int lane,
+                                                              PlannerWorkspace &workspace);
+
+  static double Evaluate(const double coefficients[6], double t);
+
+private:
+  /**
+   * @returns inverted time matrix for horizon of given timesteps,
+   * calculated and cached on first use
+   */
+  const Matrix3d &GetInverseTimeMatrix(int timesteps);
+
+  map<int, Matrix3d> inverse_time_matrices_;
+  default_random_engine random_engine_;
+
+  const double TIMESTEP = 0.02;
+};
+
+#endif /* JMT_TRAJECTORY_GENERATOR_H_ */
@@ -0,0 +1,177 @@
+/*
+ * kalman_filter_bank.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include "kalman_filter_bank.h"
+
+KalmanFilterBank::KalmanFilterBank(int capacity) {
+  this->used_count_ = 0;
+  Resize(capacity);
+}
+
+KalmanFilterBank::~KalmanFilterBank() {
+}
+
+void KalmanFilterBank::Resize(int capacity) {
+  vector<double> *columns[] = { &s_, &v_, &a_, &p_ss_, &p_sv_, &p_sa_, &p_vv_, &p_va_, &p_aa_,
+                                &d_, &d_rate_, &p_dd_, &p_dr_, &p_rr_,
+                                &measured_s_, &measured_v_, &measured_d_, &is_measured_,
+                                &k_s0_, &k_s1_, &k_v0_, &k_v1_, &k_a0_, &k_a1_, &previous_ };
+  for (int i = 0; i < sizeof(columns) / sizeof(columns[0]); ++i) {
+    columns[i]->resize(capacity, 0);
+  }
+}
+
+KalmanFilterBank::Column KalmanFilterBank::Map(vector<double> &values) {
+  return Column(values.data(), used_count_);
+}
+
+void KalmanFilterBank::Initialize(int slot, double s, double v, double d) {
+  used_count_ = max(used_count_, slot + 1);
+
+  s_[slot] = s;
+  v_[slot] = v;
+  a_[slot] = 0;
+  p_ss_[slot] = S_VARIANCE;
+  p_sv_[slot] = 0;
+  p_sa_[slot] = 0;
+  p_vv_[slot] = V_VARIANCE;
+  p_va_[slot] = 0;
+  p_aa_[slot] = INITIAL_A_VARIANCE;
+
+  d_[slot] = d;
+  d_rate_[slot] = 0;
+  p_dd_[slot] = D_VARIANCE;
+  p_dr_[slot] = 0;
+  p_rr_[slot] = INITIAL_D_RATE_VARIANCE;
+
+  is_measured_[slot] = 0;
+}
+
+void KalmanFilterBank::Predict(double elapsed_time) {
+  if (elapsed_time <= 0) {
+    return;
+  }
+
+  const double dt = elapsed_time;
+  const double h = dt * dt / 2;
+
+  //x = F * x, same as Vehicle::state_at
+  Map(s_) += dt * Map(v_) + h * Map(a_);
+  Map(v_) += dt * Map(a_);
+  Map(d_) += dt * Map(d_rate_);
+
+  //P = F * P * F^T + Q written out per entry. Each entry only reads itself and
+  //entries after it in this order, so updating them in place is safe
+  const double q = JERK_VARIANCE;
+  Map(p_ss_) += 2 * dt * Map(p_sv_) + 2 * h * Map(p_sa_) + dt * dt * Map(p_vv_) + 2 * dt * h * Map(p_va_)
+      + h * h * Map(p_aa_) + q * dt * dt * dt * dt * dt / 20;
+  Map(p_sv_) += dt * Map(p_sa_) + dt * Map(p_vv_) + (h + dt * dt) * Map(p_va_) + dt * h * Map(p_aa_)
+      + q * dt * dt * dt * dt / 8;
+  Map(p_sa_) += dt * Map(p_va_) + h * Map(p_aa_) + q * dt * dt * dt / 6;
+  Map(p_vv_) += 2 * dt * Map(p_va_) + dt * dt * Map(p_aa_) + q * dt * dt * dt / 3;
+  Map(p_va_) += dt * Map(p_aa_) + q * dt * dt / 2;
+  Map(p_aa_) += q * dt;
+
+  const double lateral_q = LATERAL_ACCELERATION_VARIANCE;
+  Map(p_dd_) += 2 * dt * Map(p_dr_) + dt * dt * Map(p_rr_) + lateral_q * dt * dt * dt / 3;
+  Map(p_dr_) += dt * Map(p_rr_) + lateral_q * dt * dt / 2;
+  Map(p_rr_) += lateral_q * dt;
+}
+
+void KalmanFilterBank::SetMeasurement(int slot, double s, double v, double d) {
+  measured_s_[slot] = s;
+  measured_v_[slot] = v;
+  measured_d_[slot] = d;
+  is_measured_[slot] = 1;
+}
+
+void KalmanFilterBank::ClearMeasurements() {
+  Map(is_measured_).setZero();
+}
+
+void KalmanFilterBank::Update() {
+  Column s = Map(s_);
+  Column v = Map(v_);
+  Column a = Map(a_);
+  Column p_ss = Map(p_ss_);
+  Column p_sv = Map(p_sv_);
+  Column p_sa = Map(p_sa_);
+  Column p_vv = Map(p_vv_);
+  Column p_va = Map(p_va_);
+  Column p_aa = Map(p_aa_);
+  Column is_measured = Map(is_measured_);
+  Column previous = Map(previous_);
+
+  //K = P * H^T * S^-1 with H picking s and v, S inverted in closed form.
+  //Gains of slots without a measurement are zeroed so they don't change
+  Column k_s0 = Map(k_s0_);
+  Column k_s1 = Map(k_s1_);
+  Column k_v0 = Map(k_v0_);
+  Column k_v1 = Map(k_v1_);
+  Column k_a0 = Map(k_a0_);
+  Column k_a1 = Map(k_a1_);
+  previous = is_measured / ((p_ss + S_VARIANCE) * (p_vv + V_VARIANCE) - p_sv * p_sv);
+  k_s0 = (p_ss * (p_vv + V_VARIANCE) - p_sv * p_sv) * previous;
+  k_s1 = p_sv * S_VARIANCE * previous;
+  k_v0 = p_sv * V_VARIANCE * previous;
+  k_v1 = (p_vv * (p_ss + S_VARIANCE) - p_sv * p_sv) * previous;
+  k_a0 = (p_sa * (p_vv + V_VARIANCE) - p_va * p_sv) * previous;
+  k_a1 = (p_va * (p_ss + S_VARIANCE) - p_sa * p_sv) * previous;
+
+  //s innovation across end of track is small, not -MAX_S
+  previous = Map(measured_s_) - s;
+  previous = (previous > MAX_S / 2).select(previous - MAX_S, (previous < -MAX_S / 2).select(previous + MAX_S, previous));
+  //measured v is not needed after this, its storage holds v innovation
+  Column v_innovation = Map(measured_v_);
+  v_innovation -= v;
+  s += k_s0 * previous + k_s1 * v_innovation;
+  v += k_v0 * previous + k_v1 * v_innovation;
+  a += k_a0 * previous + k_a1 * v_innovation;
+  s = (s >= MAX_S).select(s - MAX_S, (s < 0).select(s + MAX_S, s));
+
+  //P = (I - K * H) * P, entries that read an already updated one keep its old value in previous
+  p_aa -= k_a0 * p_sa + k_a1 * p_va;
+  previous = p_sa;
+  p_sa -= k_s0 * p_sa + k_s1 * p_va;
+  p_va -= k_v0 * previous + k_v1 * p_va;
+  previous = p_sv;
+  p_sv -= k_s0 * p_sv + k_s1 * p_vv;
+  p_vv -= k_v0 * previous + k_v1 * p_vv;
+  p_ss -= k_s0 * p_ss + k_s1 * previous;
+
+  //lateral filter measures d only
+  Column d = Map(d_);
+  Column d_rate = Map(d_rate_);
+  Column p_dd = Map(p_dd_);
+  Column p_dr = Map(p_dr_);
+  Column p_rr = Map(p_rr_);
+  k_s0 = is_measured * p_dd / (p_dd + D_VARIANCE);
+  k_s1 = is_measured * p_dr / (p_dd + D_VARIANCE);
+  previous = Map(measured_d_) - d;
+  d += k_s0 * previous;
+  d_rate += k_s1 * previous;
+  p_rr -= k_s1 * p_dr;
+  p_dr -= k_s0 * p_dr;
+  p_dd -= k_s0 * p_dd;
+}
+
+double KalmanFilterBank::S(int slot) const {
+  return s_[slot];
+}
+
+double KalmanFilterBank::V(int slot) const {
+  return v_[slot];
+}
+
+double KalmanFilterBank::A(int slot) const {
+  return a_[slot];
+}
+
+double KalmanFilterBank::D(int slot) const {
+  return d_[slot];
+}
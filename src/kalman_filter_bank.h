@@ -0,0 +1,115 @@
+/*
+ * kalman_filter_bank.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef KALMAN_FILTER_BANK_H_
+#define KALMAN_FILTER_BANK_H_
+
+#include <vector>
+#include "Eigen/Dense"
+
+using namespace std;
+
+/**
+ * One small Kalman filter per slot of VehicleTracker, all stepped together.
+ *
+ * Longitudinal filter has state [s, v, a] with the constant acceleration
+ * model of Vehicle::state_at and measures s and v (speed from vx, vy).
+ * Lateral filter has state [d, d rate] and measures d.
+ *
+ * Each state and covariance entry is its own array over slots (structure of
+ * arrays) and predict/update equations are written out per entry as Eigen
+ * array expressions, so one line updates that entry of every filter at once
+ * and is SIMD vectorized. Cost is linear in number of slots in use.
+ */
+class KalmanFilterBank {
+public:
+  explicit KalmanFilterBank(int capacity = 0);
+  virtual ~KalmanFilterBank();
+
+  void Resize(int capacity);
+
+  /**
+   * Starts filter of slot from its first measurement
+   */
+  void Initialize(int slot, double s, double v, double d);
+
+  /**
+   * Moves every filter elapsed_time seconds ahead
+   */
+  void Predict(double elapsed_time);
+
+  /**
+   * Measurement to use in next Update(), filters
+   * without one are left as predicted
+   */
+  void SetMeasurement(int slot, double s, double v, double d);
+  void ClearMeasurements();
+  void Update();
+
+  double S(int slot) const;
+  double V(int slot) const;
+  double A(int slot) const;
+  double D(int slot) const;
+
+private:
+  typedef Eigen::Map<Eigen::ArrayXd> Column;
+
+  /**
+   * @returns values of slots up to highest one ever initialized, slots are
+   * taken lowest first so the ones past it are never stepped
+   */
+  Column Map(vector<double> &values);
+
+  int used_count_;
+
+  //longitudinal state and upper triangle of its covariance
+  vector<double> s_;
+  vector<double> v_;
+  vector<double> a_;
+  vector<double> p_ss_;
+  vector<double> p_sv_;
+  vector<double> p_sa_;
+  vector<double> p_vv_;
+  vector<double> p_va_;
+  vector<double> p_aa_;
+
+  //lateral state and upper triangle of its covariance
+  vector<double> d_;
+  vector<double> d_rate_;
+  vector<double> p_dd_;
+  vector<double> p_dr_;
+  vector<double> p_rr_;
+
+  //measurements, is_measured_ is 1 for slots which have one
+  vector<double> measured_s_;
+  vector<double> measured_v_;
+  vector<double> measured_d_;
+  vector<double> is_measured_;
+
+  //gains, kept as members so Update() does not allocate
+  vector<double> k_s0_;
+  vector<double> k_s1_;
+  vector<double> k_v0_;
+  vector<double> k_v1_;
+  vector<double> k_a0_;
+  vector<double> k_a1_;
+  vector<double> previous_;
+
+  //measurement noise variances
+  const double S_VARIANCE = 0.25;
+  const double V_VARIANCE = 0.04;
+  const double D_VARIANCE = 0.04;
+  //process noise, white jerk and white lateral acceleration
+  const double JERK_VARIANCE = 1;
+  const double LATERAL_ACCELERATION_VARIANCE = 0.5;
+  const double INITIAL_A_VARIANCE = 4;
+  const double INITIAL_D_RATE_VARIANCE = 1;
+  // The max s value before wrapping around the track back to 0
+  const double MAX_S = 6945.554;
+};
+
+#endif /* KALMAN_FILTER_BANK_H_ */
@@ -0,0 +1,164 @@
+/*
+ * lattice_planner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "map_utils.h"
+#include "lattice_planner.h"
+
+LatticePlanner::LatticePlanner(int stations_count, double station_spacing)
+    : stations_count_(stations_count),
+      station_spacing_(station_spacing) {
+  this->start_s_ = 0;
+  this->start_t_ = 0;
+  this->ego_v_ = 0;
+}
+
+LatticePlanner::~LatticePlanner() {
+}
+
+int LatticePlanner::StationsCount() const {
+  return stations_count_;
+}
+
+double LatticePlanner::StationOffset(int station) const {
+  return (station + 1) * station_spacing_;
+}
+
+double LatticePlanner::PathD(int station) const {
+  return path_d_[station];
+}
+
+double LatticePlanner::NodeCost(const vector<Vehicle> &vehicles, int station, double d) const {
+  double s = start_s_ + StationOffset(station);
+  //time at which ego vehicle reaches this station
+  double t = start_t_ + StationOffset(station) / max(ego_v_, 1.0);
+
+  //ego vehicle is about 2m wide so on a lane boundary it occupies both lanes
+  int left_lane = MapUtils::GetLane(d - 1);
+  int right_lane = MapUtils::GetLane(d + 1);
+
+  int lane = MapUtils::GetLane(d);
+  double cost = OFF_CENTER_COST * fabs(d - MapUtils::GetdValueForLaneCenter(lane)) / (MapUtils::GetLaneWidth(lane) / 2);
+
+  const int vehicles_count = vehicles.size();
+  for (int i = 0; i < vehicles_count; ++i) {
+    const Vehicle &vehicle = vehicles[i];
+    if (vehicle.lane != left_lane && vehicle.lane != right_lane) {
+      continue;
+    }
+
+    double gap = vehicle.s_at(t) - s;
+    if (fabs(gap) < COLLISION_DISTANCE) {
+      cost += COLLISION_COST;
+    } else if (gap > 0 && gap < BUFFER_DISTANCE * 3) {
+      //leading vehicle, the closer and slower the worse
+      cost += BUFFER_COST * exp(-gap / BUFFER_DISTANCE);
+      cost += SLOW_LEADER_COST * max(0.0, ego_v_ - vehicle.v_at(t));
+    }
+  }
+
+  return cost;
+}
+
+void LatticePlanner::Plan(const vector<Vehicle> &vehicles,
+                          double start_s,
+                          double start_d,
+                          double start_t,
+                          double ego_v,
+                          int lanes_count,
+                          int current_lane,
+                          int min_end_lane,
+                          int max_end_lane) {
+  start_s_ = start_s;
+  start_t_ = start_t;
+  ego_v_ = ego_v;
+
+  //lane centers and lane boundaries between them
+  offsets_.clear();
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    if (lane > 0) {
+      offsets_.push_back(MapUtils::GetdValueForLaneBoundary(lane));
+    }
+    offsets_.push_back(MapUtils::GetdValueForLaneCenter(lane));
+  }
+  const int offsets_count = offsets_.size();
+
+  //costs of nodes depend only on predictions, compute them once
+  node_costs_.resize(stations_count_ * offsets_count);
+  for (int station = 0; station < stations_count_; ++station) {
+    for (int j = 0; j < offsets_count; ++j) {
+      node_costs_[station * offsets_count + j] = NodeCost(vehicles, station, offsets_[j]);
+    }
+  }
+
+  //path starts from lattice offset nearest to start_d, otherwise a start slightly
+  //past a boundary could never reach a lane center at first station. It is kept
+  //to current lane and its boundaries (lane center j is at 2 * lane), so while
+  //a lane change is under way path can't start back from lane we left
+  int start_offset = 0;
+  for (int j = 1; j < offsets_count; ++j) {
+    if (fabs(offsets_[j] - start_d) < fabs(offsets_[start_offset] - start_d)) {
+      start_offset = j;
+    }
+  }
+  start_offset = max(2 * current_lane - 1, min(start_offset, 2 * current_lane + 1));
+  start_offset = max(0, min(start_offset, offsets_count - 1));
+
+  //dynamic programming, cheapest path to each node from start (start offset at station -1)
+  path_costs_.assign(stations_count_ * offsets_count, 1e12);
+  parents_.assign(stations_count_ * offsets_count, -1);
+  for (int station = 0; station < stations_count_; ++station) {
+    for (int j = 0; j < offsets_count; ++j) {
+      double best = 1e12;
+      int parent = -1;
+      if (station == 0) {
+        double step = fabs(offsets_[j] - offsets_[start_offset]);
+        if (abs(j - start_offset) <= MAX_OFFSETS_STEP) {
+          best = LATERAL_MOVE_COST * step * step;
+        }
+      } else {
+        for (int k = 0; k < offsets_count; ++k) {
+          double step = fabs(offsets_[j] - offsets_[k]);
+          if (abs(j - k) > MAX_OFFSETS_STEP) {
+            continue;
+          }
+          double cost = path_costs_[(station - 1) * offsets_count + k] + LATERAL_MOVE_COST * step * step;
+          if (cost < best) {
+            best = cost;
+            parent = k;
+          }
+        }
+      }
+      path_costs_[station * offsets_count + j] = best + node_costs_[station * offsets_count + j];
+      parents_[station * offsets_count + j] = parent;
+    }
+  }
+
+  //cheapest node at last station, ending in center of a lane path may end in
+  int best_offset = -1;
+  double best_cost = 0;
+  const int last_station = stations_count_ - 1;
+  for (int lane = min_end_lane; lane <= max_end_lane; ++lane) {
+    const int j = 2 * lane;
+    double cost = path_costs_[last_station * offsets_count + j];
+    if (lane != current_lane) {
+      cost += LANE_SWITCH_COST;
+    }
+    if (best_offset == -1 || cost < best_cost) {
+      best_offset = j;
+      best_cost = cost;
+    }
+  }
+
+  //walk back through parents
+  path_d_.resize(stations_count_);
+  for (int station = last_station; station >= 0; --station) {
+    path_d_[station] = offsets_[best_offset];
+    best_offset = parents_[station * offsets_count + best_offset];
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ * lattice_planner.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef LATTICE_PLANNER_H_
+#define LATTICE_PLANNER_H_
+
+#include <vector>
+#include "vehicle.h"
+
+using namespace std;
+
+/**
+ * Plans a path over a lattice of s-stations ahead of ego vehicle and lateral
+ * offsets (lane centers and lane boundaries in between). Node costs come from
+ * predicted positions of other vehicles at time ego vehicle reaches a station,
+ * edge costs from lateral movement. Cheapest path is found with dynamic
+ * programming in O(stations * offsets^2) and its nodes are meant to be used
+ * as anchors of a smoothing spline.
+ */
+class LatticePlanner {
+public:
+  LatticePlanner(int stations_count = 6, double station_spacing = 15);
+  virtual ~LatticePlanner();
+
+  /**
+   * @param start_s, start_d  where path starts (end of previous path)
+   * @param start_t  time from now in seconds at which ego vehicle will be at start_s
+   * @param ego_v  velocity ego vehicle is going to keep in meters/second
+   * @param current_lane  lane ego vehicle is in or changing to, path starts on
+   * its side and pays LANE_SWITCH_COST for ending in any other lane
+   * @param min_end_lane, max_end_lane  lanes path may end in
+   */
+  void Plan(const vector<Vehicle> &vehicles,
+            double start_s,
+            double start_d,
+            double start_t,
+            double ego_v,
+            int lanes_count,
+            int current_lane,
+            int min_end_lane,
+            int max_end_lane);
+
+  int StationsCount() const;
+
+  /**
+   * @returns s of station relative to start_s
+   */
+  double StationOffset(int station) const;
+
+  /**
+   * @returns lateral offset (d) of planned path at station
+   */
+  double PathD(int station) const;
+
+private:
+  double NodeCost(const vector<Vehicle> &vehicles, int station, double d) const;
+
+  const int stations_count_;
+  const double station_spacing_;
+
+  double start_s_;
+  double start_t_;
+  double ego_v_;
+
+  //lateral offsets of lattice
+  vector<double> offsets_;
+  //[station][offset] tables, kept to reuse capacity
+  vector<double> node_costs_;
+  vector<double> path_costs_;
+  vector<int> parents_;
+
+  //result, d per station
+  vector<double> path_d_;
+
+  const double COLLISION_DISTANCE = 15;
+  const double BUFFER_DISTANCE = 30;
+  const double COLLISION_COST = 1000;
+  const double BUFFER_COST = 30;
+  //for each m/s a leader is slower than ego vehicle
+  const double SLOW_LEADER_COST = 2;
+  //for not being in center of a lane
+  const double OFF_CENTER_COST = 5;
+  //per squared meter of lateral movement between stations
+  const double LATERAL_MOVE_COST = 1;
+  //for ending in a lane other than current one, so that lattice re-solved
+  //every cycle doesn't flip between lanes whose costs are close
+  const double LANE_SWITCH_COST = 30;
+  //max lateral movement between two stations, from a lane
+  //center to a boundary or the other way, whatever lane widths are
+  const int MAX_OFFSETS_STEP = 1;
+};
+
+#endif /* LATTICE_PLANNER_H_ */
@@ -15,6 +15,8 @@
 #include "map_utils.h"
 #include "trajectory_generator.h"
 #include "path_planner.h"
+#include "control_message_writer.h"
+#include "previous_path_scanner.h"
 
 using namespace std;
 
@@ -36,14 +38,20 @@ string hasData(string s) {
   return "";
 }
 
-int MyCode();
+int MyCode(PlannerMode mode);
 
-int main() {
-  MyCode();
+//Usage: path_planning [candidate_scoring|lattice|jmt_sampling]
+int main(int argc, char **argv) {
+  PlannerMode mode = CANDIDATE_SCORING;
+  if (argc > 1 && !PathPlanner::ParseMode(argv[1], mode)) {
+    cerr << "Unknown planner mode " << argv[1] << ", use candidate_scoring, lattice or jmt_sampling" << endl;
+    return 1;
+  }
+  MyCode(mode);
   return 0;
 }
 
-int MyCode() {
+int MyCode(PlannerMode mode) {
   uWS::Hub h;
 
   // Waypoint map to read from
@@ -52,9 +60,13 @@ int MyCode() {
   MapUtils::Initialize(map_file);
 
   //Initialize path planner
-  PathPlanner path_planner;
+  PathPlanner path_planner(mode);
+  //reuses text of points we sent last time which come back as previous path
+  ControlMessageWriter control_message_writer;
+  //finds previous path in telemetry without parsing its numbers
+  PreviousPathScanner previous_path_scanner;
 
-  h.onMessage([&path_planner]
+  h.onMessage([&path_planner, &control_message_writer, &previous_path_scanner]
                (uWS::WebSocket<uWS::SERVER> ws, char *data, size_t length, uWS::OpCode opCode) {
     // "42" at the start of the message means there's a websocket message event.
     // The 4 signifies a websocket message
@@ -66,6 +78,15 @@ int MyCode() {
       auto s = hasData(data);
 
       if (s != "") {
+        //previous path is what is left of path we sent last time. If planner
+        //still has that, only size and end points are needed and the rest
+        //of both arrays is blanked so json parser does not parse it
+        bool is_emitted_path = previous_path_scanner.Scan(s)
+            && path_planner.IsEmittedPath(previous_path_scanner.Ends());
+        if (is_emitted_path) {
+          previous_path_scanner.Blank(s);
+        }
+
         auto j = json::parse(s);
 
         string event = j[0].get<string>();
@@ -81,9 +102,6 @@ int MyCode() {
           double car_yaw = j[1]["yaw"];
           double car_speed = j[1]["speed"];
 
-          // Previous path data given to the Planner
-          vector<double> previous_path_x = j[1]["previous_path_x"];
-          vector<double> previous_path_y = j[1]["previous_path_y"];
           // Previous path's end s and d values
           double end_path_s = j[1]["end_path_s"];
           double end_path_d = j[1]["end_path_d"];
@@ -96,22 +114,25 @@ int MyCode() {
           /***********Process Data****************/
 
           Vehicle ego_vehicle(-1, car_x, car_y, car_s, car_d, Utils::deg2rad(car_yaw), car_speed, 0);
-          CartesianTrajectory trajectory = path_planner.GenerateTrajectory(ego_vehicle, sensor_fusion, previous_path_x,
-              previous_path_y, end_path_s, end_path_d);
+          // Previous path data given to the Planner, only parsed if planner does not have it
+          CartesianTrajectory trajectory = is_emitted_path
+              ? path_planner.GenerateTrajectory(ego_vehicle, sensor_fusion, previous_path_scanner.Ends(),
+                                                end_path_s, end_path_d)
+              : path_planner.GenerateTrajectory(ego_vehicle, sensor_fusion,
+                                                j[1]["previous_path_x"].get<vector<double> >(),
+                                                j[1]["previous_path_y"].get<vector<double> >(),
+                                                end_path_s, end_path_d);
 
           /***************END Processing of data***************/
 
-          json msgJson;
-
           // define a path made up of (x,y) points that the car will visit sequentially every .02 seconds
-          msgJson["next_x"] = trajectory.x_values;
-          msgJson["next_y"] = trajectory.y_values;
-
-          auto msg = "42[\"control\","+ msgJson.dump()+"]";
+          const string &msg = control_message_writer.Write(trajectory);
 
           //this_thread::sleep_for(chrono::milliseconds(1000));
           ws.send(msg.data(), msg.length(), uWS::OpCode::TEXT);
 
+          //reply is out, planner can use the time until next telemetry
+          path_planner.PrecomputeNextCycle();
         }
       } else {
         // Manual driving
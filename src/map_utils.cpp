@@ -5,8 +5,10 @@
  *      Author: ramiz
  */
 
+#include <algorithm>
 #include <fstream>
 #include "utils.h"
+#include "spline.h"
 #include "map_utils.h"
 
 bool MapUtils::is_initialized_ = false;
@@ -15,8 +17,28 @@ vector<double> MapUtils::map_waypoints_y_;
 vector<double> MapUtils::map_waypoints_s_;
 vector<double> MapUtils::map_waypoints_dx_;
 vector<double> MapUtils::map_waypoints_dy_;
-
-void MapUtils::Initialize(const string &map_file) {
+vector<double> MapUtils::reference_x_;
+vector<double> MapUtils::reference_y_;
+vector<double> MapUtils::reference_heading_;
+vector<double> MapUtils::reference_curvature_;
+vector<double> MapUtils::reference_normal_x_;
+vector<double> MapUtils::reference_normal_y_;
+vector<double> MapUtils::lane_centers_;
+vector<double> MapUtils::lane_boundaries_;
+vector<int> MapUtils::lanes_by_cell_;
+vector<double> MapUtils::speed_limits_;
+
+const double MapUtils::MAX_LATERAL_ACCELERATION = 4;
+const double MapUtils::CURVE_DECELERATION = 2;
+const double MapUtils::MAX_SPEED_LIMIT = 100;
+
+const double MapUtils::LANE_LOOKUP_STEP = 0.25;
+
+const double MapUtils::REFERENCE_LINE_STEP = 0.5;
+const double MapUtils::MAX_S = 6945.554;
+const double MapUtils::FRENET_SEARCH_DISTANCE = 100;
+
+void MapUtils::Initialize(const string &map_file, const vector<double> &lane_widths) {
   // Load up map values for waypoint's x,y,s and d normalized normal vectors
 
   ifstream in_map_(map_file.c_str(), ifstream::in);
@@ -46,10 +68,135 @@ void MapUtils::Initialize(const string &map_file) {
     map_waypoints_dy_.push_back(d_y);
   }
 
+  BuildReferenceLine();
+  BuildRoadModel(lane_widths);
+  BuildSpeedLimitProfile();
+
   is_initialized_ = true;
   cout << "map reading complete" << endl;
 }
 
+void MapUtils::BuildReferenceLine() {
+  //track is a loop so a few waypoints from each end are repeated
+  //past the other end, otherwise spline would bend at start/end
+  const int waypoints_count = map_waypoints_s_.size();
+  const int wrapped_count = 3;
+  vector<double> spline_s;
+  vector<double> spline_x;
+  vector<double> spline_y;
+  for (int i = waypoints_count - wrapped_count; i < waypoints_count; ++i) {
+    spline_s.push_back(map_waypoints_s_[i] - MAX_S);
+    spline_x.push_back(map_waypoints_x_[i]);
+    spline_y.push_back(map_waypoints_y_[i]);
+  }
+  for (int i = 0; i < waypoints_count; ++i) {
+    spline_s.push_back(map_waypoints_s_[i]);
+    spline_x.push_back(map_waypoints_x_[i]);
+    spline_y.push_back(map_waypoints_y_[i]);
+  }
+  for (int i = 0; i < wrapped_count; ++i) {
+    spline_s.push_back(map_waypoints_s_[i] + MAX_S);
+    spline_x.push_back(map_waypoints_x_[i]);
+    spline_y.push_back(map_waypoints_y_[i]);
+  }
+
+  tk::spline x_spline;
+  tk::spline y_spline;
+  x_spline.set_points(spline_s, spline_x);
+  y_spline.set_points(spline_s, spline_y);
+
+  //one more sample past MAX_S so every s in [0, MAX_S) has a next sample
+  const int samples_count = int(MAX_S / REFERENCE_LINE_STEP) + 2;
+  reference_x_.resize(samples_count);
+  reference_y_.resize(samples_count);
+  reference_heading_.resize(samples_count);
+  reference_curvature_.resize(samples_count);
+  reference_normal_x_.resize(samples_count);
+  reference_normal_y_.resize(samples_count);
+  for (int i = 0; i < samples_count; ++i) {
+    double s = i * REFERENCE_LINE_STEP;
+    double dx = x_spline.deriv(1, s);
+    double dy = y_spline.deriv(1, s);
+    double ddx = x_spline.deriv(2, s);
+    double ddy = y_spline.deriv(2, s);
+    double heading = atan2(dy, dx);
+
+    reference_x_[i] = x_spline(s);
+    reference_y_[i] = y_spline(s);
+    reference_heading_[i] = heading;
+    reference_curvature_[i] = (dx * ddy - dy * ddx) / pow(dx * dx + dy * dy, 1.5);
+    //d increases to the right of driving direction
+    reference_normal_x_[i] = sin(heading);
+    reference_normal_y_[i] = -cos(heading);
+  }
+}
+
+void MapUtils::BuildRoadModel(const vector<double> &lane_widths) {
+  const int lanes_count = lane_widths.size();
+  lane_centers_.resize(lanes_count);
+  lane_boundaries_.resize(lanes_count + 1);
+  lane_boundaries_[0] = 0;
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    lane_centers_[lane] = lane_boundaries_[lane] + lane_widths[lane] / 2;
+    lane_boundaries_[lane + 1] = lane_boundaries_[lane] + lane_widths[lane];
+  }
+
+  //a boundary belongs to lane on its left, so start of
+  //a cell which is exactly on a boundary is in lane on left
+  const int cells_count = int(lane_boundaries_[lanes_count] / LANE_LOOKUP_STEP) + 1;
+  lanes_by_cell_.resize(cells_count);
+  int lane = 0;
+  for (int cell = 0; cell < cells_count; ++cell) {
+    while (lane < lanes_count - 1 && cell * LANE_LOOKUP_STEP > lane_boundaries_[lane + 1]) {
+      ++lane;
+    }
+    lanes_by_cell_[cell] = lane;
+  }
+}
+
+void MapUtils::BuildSpeedLimitProfile() {
+  const int samples_count = reference_curvature_.size();
+  const double road_width = lane_boundaries_.back();
+  speed_limits_.resize(samples_count);
+  for (int i = 0; i < samples_count; ++i) {
+    //lanes on inner side of a curve turn sharper than reference line,
+    //d = 0 is inner side of left turns and d = road_width of right turns
+    double curvature = reference_curvature_[i];
+    double inner_d = curvature > 0 ? 0 : road_width;
+    double lane_curvature = fabs(curvature / (1 + curvature * inner_d));
+
+    double limit = MAX_SPEED_LIMIT;
+    if (lane_curvature * MAX_SPEED_LIMIT * MAX_SPEED_LIMIT > MAX_LATERAL_ACCELERATION) {
+      limit = sqrt(MAX_LATERAL_ACCELERATION / lane_curvature);
+    }
+    speed_limits_[i] = limit;
+  }
+
+  //limit at each sample must allow slowing down to limits of samples after it,
+  //v^2 = v_next^2 + 2 * a * ds. Track is a loop so curves at its start
+  //affect its end, going over it twice covers that
+  const int loop_samples_count = samples_count - 1;
+  for (int k = 2 * loop_samples_count - 1; k >= 0; --k) {
+    int i = k % loop_samples_count;
+    int next = (i + 1) % loop_samples_count;
+    double next_limit = speed_limits_[next];
+    speed_limits_[i] = min(speed_limits_[i],
+                           sqrt(next_limit * next_limit + 2 * CURVE_DECELERATION * REFERENCE_LINE_STEP));
+  }
+  speed_limits_[loop_samples_count] = speed_limits_[0];
+}
+
+void MapUtils::FindReferenceLineSample(double s, int &index, double &fraction) {
+  s = fmod(s, MAX_S);
+  if (s < 0) {
+    s += MAX_S;
+  }
+
+  double position = s / REFERENCE_LINE_STEP;
+  index = int(position);
+  fraction = position - index;
+}
+
 int MapUtils::ClosestWaypoint(double x, double y) {
   CheckInitialization();
 
@@ -92,102 +239,139 @@ int MapUtils::NextWaypoint(double x, double y, double theta) {
 
 // Transform from Cartesian x,y coordinates to Frenet s,d coordinates
 vector<double> MapUtils::getFrenet(double x, double y, double theta) {
-  CheckInitialization();
+  double s;
+  double d;
+  getFrenet(x, y, theta, s, d);
 
-  int next_wp = NextWaypoint(x, y, theta);
-
-  int prev_wp;
-  prev_wp = next_wp - 1;
-  if (next_wp == 0) {
-    prev_wp = map_waypoints_x_.size() - 1;
-  }
-
-  double n_x = map_waypoints_x_[next_wp] - map_waypoints_x_[prev_wp];
-  double n_y = map_waypoints_y_[next_wp] - map_waypoints_y_[prev_wp];
-  double x_x = x - map_waypoints_x_[prev_wp];
-  double x_y = y - map_waypoints_y_[prev_wp];
-
-  // find the projection of x onto n
-  double proj_norm = (x_x * n_x + x_y * n_y) / (n_x * n_x + n_y * n_y);
-  double proj_x = proj_norm * n_x;
-  double proj_y = proj_norm * n_y;
-
-  double frenet_d = Utils::euclidean(x_x, x_y, proj_x, proj_y);
-
-  //see if d value is positive or negative by comparing it to a center point
-  double center_x = 1000 - map_waypoints_x_[prev_wp];
-  double center_y = 2000 - map_waypoints_y_[prev_wp];
-  double centerToPos = Utils::euclidean(center_x, center_y, x_x, x_y);
-  double centerToRef = Utils::euclidean(center_x, center_y, proj_x, proj_y);
+  return {s,d};
+}
 
-  if (centerToPos <= centerToRef) {
-    frenet_d *= -1;
-  }
+void MapUtils::getFrenet(double x, double y, double theta, double &s, double &d) {
+  CheckInitialization();
 
-  // calculate s value
-  double frenet_s = 0;
-  for (int i = 0; i < prev_wp; i++) {
-    frenet_s += Utils::euclidean(map_waypoints_x_[i], map_waypoints_y_[i],
-        map_waypoints_x_[i + 1], map_waypoints_y_[i + 1]);
+  //closest waypoint tells roughly where on reference line we are, samples
+  //around it are searched coarsely first and then one by one near best one
+  int closest_wp = ClosestWaypoint(x, y);
+  const int loop_samples_count = int(MAX_S / REFERENCE_LINE_STEP) + 1;
+  const int coarse_step = 10;
+  int closest = int(map_waypoints_s_[closest_wp] / REFERENCE_LINE_STEP);
+  int search_radius = int(FRENET_SEARCH_DISTANCE / REFERENCE_LINE_STEP);
+  for (int step = coarse_step; step >= 1; step /= coarse_step) {
+    int center = closest;
+    double closest_distance = 1e12;
+    for (int k = center - search_radius; k <= center + search_radius; k += step) {
+      int i = (k % loop_samples_count + loop_samples_count) % loop_samples_count;
+      double dx = x - reference_x_[i];
+      double dy = y - reference_y_[i];
+      if (dx * dx + dy * dy < closest_distance) {
+        closest_distance = dx * dx + dy * dy;
+        closest = i;
+      }
+    }
+    search_radius = step;
   }
 
-  frenet_s += Utils::euclidean(0, 0, proj_x, proj_y);
-
-  return {frenet_s,frenet_d};
+  //project on tangent and normal of closest sample, it is
+  //at most half a step away so tangent is as good as the curve
+  double dx = x - reference_x_[closest];
+  double dy = y - reference_y_[closest];
+  double heading = reference_heading_[closest];
 
+  s = closest * REFERENCE_LINE_STEP + dx * cos(heading) + dy * sin(heading);
+  s = fmod(s + MAX_S, MAX_S);
+  d = dx * reference_normal_x_[closest] + dy * reference_normal_y_[closest];
 }
 
 // Transform from Frenet s,d coordinates to Cartesian x,y
 vector<double> MapUtils::getXY(double s, double d) {
-  CheckInitialization();
+  double x;
+  double y;
+  getXY(s, d, x, y);
 
-  int prev_wp = -1;
+  return {x,y};
+}
 
-  while (s > map_waypoints_s_[prev_wp + 1]
-      && (prev_wp < (int) (map_waypoints_s_.size() - 1))) {
-    prev_wp++;
-  }
+void MapUtils::getXY(double s, double d, double &x, double &y) {
+  double ref_x;
+  double ref_y;
+  double normal_x;
+  double normal_y;
+  GetReferencePoint(s, ref_x, ref_y, normal_x, normal_y);
 
-  int wp2 = (prev_wp + 1) % map_waypoints_x_.size();
+  x = ref_x + d * normal_x;
+  y = ref_y + d * normal_y;
+}
 
-  double heading = atan2((map_waypoints_y_[wp2] - map_waypoints_y_[prev_wp]),
-      (map_waypoints_x_[wp2] - map_waypoints_x_[prev_wp]));
-  // the x,y,s along the segment
-  double seg_s = (s - map_waypoints_s_[prev_wp]);
+void MapUtils::GetReferencePoint(double s, double &x, double &y, double &normal_x, double &normal_y) {
+  CheckInitialization();
 
-  double seg_x = map_waypoints_x_[prev_wp] + seg_s * cos(heading);
-  double seg_y = map_waypoints_y_[prev_wp] + seg_s * sin(heading);
+  int i;
+  double fraction;
+  FindReferenceLineSample(s, i, fraction);
 
-  double perp_heading = heading - M_PI / 2;
+  //samples are close enough that linear interpolation between
+  //two of them is as smooth as the splines they come from
+  x = reference_x_[i] + fraction * (reference_x_[i + 1] - reference_x_[i]);
+  y = reference_y_[i] + fraction * (reference_y_[i + 1] - reference_y_[i]);
+  normal_x = reference_normal_x_[i] + fraction * (reference_normal_x_[i + 1] - reference_normal_x_[i]);
+  normal_y = reference_normal_y_[i] + fraction * (reference_normal_y_[i + 1] - reference_normal_y_[i]);
+}
 
-  double x = seg_x + d * cos(perp_heading);
-  double y = seg_y + d * sin(perp_heading);
+double MapUtils::GetHeading(double s) {
+  CheckInitialization();
 
-  return {x,y};
+  int i;
+  double fraction;
+  FindReferenceLineSample(s, i, fraction);
 
+  //heading may wrap around between two samples
+  double delta = reference_heading_[i + 1] - reference_heading_[i];
+  delta = atan2(sin(delta), cos(delta));
+  return reference_heading_[i] + fraction * delta;
 }
 
 FrenetTrajectory MapUtils::CartesianToFrenet(const CartesianTrajectory &cartesian_trajectory,
                                                     const double ref_yaw) {
+  return CartesianToFrenet(cartesian_trajectory, ref_yaw, TrajectoryValues(), TrajectoryValues());
+}
 
-  vector<double> s_values;
-  vector<double> d_values;
+FrenetTrajectory MapUtils::CartesianToFrenet(const CartesianTrajectory &cartesian_trajectory,
+                                             const double ref_yaw,
+                                             const TrajectoryValues &known_s_values,
+                                             const TrajectoryValues &known_d_values) {
 
-  //get first point as it will be from previous path
-  //we will use it for angle calculation which is
-  //tangent line (slope) between two points
-  double prev_x = cartesian_trajectory.x_values[0];
-  double prev_y = cartesian_trajectory.y_values[0];
+  //Frenet values are allocated from same arena as the Cartesian ones
+  const int num_timesteps = cartesian_trajectory.x_values.size();
+  TrajectoryValues s_values(cartesian_trajectory.x_values.get_allocator());
+  TrajectoryValues d_values(cartesian_trajectory.x_values.get_allocator());
+  s_values.reserve(num_timesteps);
+  d_values.reserve(num_timesteps);
+
+  //take already known values as they are
+  const int known_count = min((int) known_s_values.size(), num_timesteps);
+  s_values.insert(s_values.end(), known_s_values.begin(), known_s_values.begin() + known_count);
+  d_values.insert(d_values.end(), known_d_values.begin(), known_d_values.begin() + known_count);
+
+  double s;
+  double d;
+  int start_index = known_count;
+  if (known_count == 0) {
+    //get first point as it will be from previous path
+    //we will use it for angle calculation which is
+    //tangent line (slope) between two points
+    //convert this point to Frenet
+    getFrenet(cartesian_trajectory.x_values[0], cartesian_trajectory.y_values[0], ref_yaw, s, d);
+    s_values.push_back(s);
+    d_values.push_back(d);
+    start_index = 1;
+  }
 
-  //convert this point to Frenet
-  vector<double> frenet = getFrenet(prev_x, prev_y, ref_yaw);
-  s_values.push_back(frenet[0]);
-  d_values.push_back(frenet[1]);
+  double prev_x = cartesian_trajectory.x_values[start_index - 1];
+  double prev_y = cartesian_trajectory.y_values[start_index - 1];
 
   //for each point in trajectory predict where other vehicle
   //will be at that point in time to see if there is a collision
-  const int num_timesteps = cartesian_trajectory.x_values.size();
-  for (int i = 1; i < num_timesteps; ++i) {
+  for (int i = start_index; i < num_timesteps; ++i) {
     double next_x = cartesian_trajectory.x_values[i];
     double next_y = cartesian_trajectory.y_values[i];
 
@@ -195,31 +379,37 @@ FrenetTrajectory MapUtils::CartesianToFrenet(const CartesianTrajectory &cartesia
     //which is slope (tangent) between this and previous point
     double yaw = atan2(next_y - prev_y, next_x - prev_x);
     //convert current trajectory point to Frenet coordinate system
-    vector<double> sd = MapUtils::getFrenet(next_x, next_y, yaw);
+    MapUtils::getFrenet(next_x, next_y, yaw, s, d);
 
-    s_values.push_back(sd[0]);
-    d_values.push_back(sd[1]);
+    s_values.push_back(s);
+    d_values.push_back(d);
 
     prev_x = next_x;
     prev_y = next_y;
   }
 
-  return FrenetTrajectory(s_values, d_values, cartesian_trajectory.reference_velocity, cartesian_trajectory.lane);
+  return FrenetTrajectory(std::move(s_values), std::move(d_values), cartesian_trajectory.reference_velocity,
+                          cartesian_trajectory.lane);
 }
 
 CartesianTrajectory MapUtils::FrenetToCartesian(const FrenetTrajectory &frenet_trajectory) {
-  vector<double> x_values;
-  vector<double> y_values;
-
   const int points_count = frenet_trajectory.s_values.size();
+  TrajectoryValues x_values(frenet_trajectory.s_values.get_allocator());
+  TrajectoryValues y_values(frenet_trajectory.s_values.get_allocator());
+  x_values.reserve(points_count);
+  y_values.reserve(points_count);
+
   for (int i = 0; i < points_count; ++i) {
-    vector<double> xy = getXY(frenet_trajectory.s_values[i], frenet_trajectory.d_values[i]);
+    double x;
+    double y;
+    getXY(frenet_trajectory.s_values[i], frenet_trajectory.d_values[i], x, y);
 
-    x_values.push_back(xy[0]);
-    y_values.push_back(xy[1]);
+    x_values.push_back(x);
+    y_values.push_back(y);
   }
 
-  return CartesianTrajectory(x_values, y_values, frenet_trajectory.reference_velocity, frenet_trajectory.lane);
+  return CartesianTrajectory(std::move(x_values), std::move(y_values), frenet_trajectory.reference_velocity,
+                             frenet_trajectory.lane);
 }
 
 void MapUtils::CheckInitialization() {
@@ -258,20 +448,41 @@ void MapUtils::TransformFromVehicleToMapCoordinates(double ref_x, double ref_y,
 }
 
 int MapUtils::GetLane(double d) {
-  if (d >= 0 && d <= 4) {
-    return 0;
-  } else if (d > 4 && d <= 8) {
-    return 1;
-  } else if (d > 8 && d <= 12) {
-    return 2;
+  if (d < 0 || d > lane_boundaries_.back()) {
+    return -1;
   }
 
-  return -1;
+  int lane = lanes_by_cell_[int(d / LANE_LOOKUP_STEP)];
+  if (d > lane_boundaries_[lane + 1]) {
+    //cell goes over boundary to next lane
+    ++lane;
+  }
+
+  return lane;
+}
+
+double MapUtils::GetSpeedLimit(double s) {
+  CheckInitialization();
+
+  int i;
+  double fraction;
+  FindReferenceLineSample(s, i, fraction);
+
+  return speed_limits_[i] + fraction * (speed_limits_[i + 1] - speed_limits_[i]);
 }
 
 double MapUtils::GetdValueForLaneCenter(int lane) {
-  //as car drives in center so add 2m for to count current lane
-  //and as each lane is 4m so multiply by 4 to count other lanes before on left
-  return 2 + lane * 4;
+  return lane_centers_[lane];
+}
+
+double MapUtils::GetdValueForLaneBoundary(int lane) {
+  return lane_boundaries_[lane];
+}
+
+double MapUtils::GetLaneWidth(int lane) {
+  return lane_boundaries_[lane + 1] - lane_boundaries_[lane];
 }
 
+int MapUtils::LanesCount() {
+  return lane_centers_.size();
+}
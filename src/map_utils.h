@@ -17,21 +17,78 @@ using namespace std;
 
 class MapUtils {
 public:
-  static void Initialize(const string &map_file);
+  /**
+   * @param lane_widths  width of each lane in meters, from left (d = 0) to right
+   */
+  static void Initialize(const string &map_file, const vector<double> &lane_widths = vector<double>(3, 4.0));
   static int ClosestWaypoint(double x, double y);
   static int NextWaypoint(double x, double y, double theta);
   static vector<double> getFrenet(double x, double y, double theta);
+  static void getFrenet(double x, double y, double theta, double &s, double &d);
   static vector<double> getXY(double s, double d);
+  static void getXY(double s, double d, double &x, double &y);
+  /**
+   * Point of reference line (d = 0) at s and its unit normal, point at
+   * (s, d) is (x + d * normal_x, y + d * normal_y) which is what getXY does
+   */
+  static void GetReferencePoint(double s, double &x, double &y, double &normal_x, double &normal_y);
   static FrenetTrajectory CartesianToFrenet(const CartesianTrajectory &cartesian_trajectory, const double ref_yaw);
+  /**
+   * Same as above but Frenet values of first known_s_values.size() points are
+   * already known (e.g. points carried over from previous path) and are copied
+   * instead of converted, only the remaining points are converted
+   */
+  static FrenetTrajectory CartesianToFrenet(const CartesianTrajectory &cartesian_trajectory, const double ref_yaw,
+                                            const TrajectoryValues &known_s_values,
+                                            const TrajectoryValues &known_d_values);
   static CartesianTrajectory FrenetToCartesian(const FrenetTrajectory &frenet_trajectory);
 
   static void TransformToVehicleCoordinates(double ref_x, double ref_y, double ref_yaw, double &x, double &y);
   static void TransformFromVehicleToMapCoordinates(double ref_x, double ref_y, double ref_yaw, double &x, double &y);
+  /**
+   * @returns lane d is in, -1 if it is off the road
+   */
   static int GetLane(double d);
   static double GetdValueForLaneCenter(int lane);
+  /**
+   * @returns d value of boundary between lane - 1 and lane (left edge of lane)
+   */
+  static double GetdValueForLaneBoundary(int lane);
+  static double GetLaneWidth(int lane);
+  static int LanesCount();
+
+  /**
+   * Heading (radians) of reference line at s
+   */
+  static double GetHeading(double s);
+  /**
+   * @returns max velocity (meters/second) at s, from curvature of the road.
+   * It already leaves room to slow down for curves further ahead
+   */
+  static double GetSpeedLimit(double s);
 
 public:
   static void CheckInitialization();
+  /**
+   * Fits splines x(s) and y(s) through waypoints and samples them every
+   * REFERENCE_LINE_STEP meters so that lookups by s are an index and a
+   * linear interpolation between two close samples
+   */
+  static void BuildReferenceLine();
+  /**
+   * @param index  set to sample at or before s (s wrapped to track length)
+   * @param fraction  set to position of s between sample index and next one
+   */
+  static void FindReferenceLineSample(double s, int &index, double &fraction);
+  /**
+   * Builds lane boundaries and lookup table of lanes by d
+   */
+  static void BuildRoadModel(const vector<double> &lane_widths);
+  /**
+   * Speed limit at each reference line sample which keeps lateral
+   * acceleration within MAX_LATERAL_ACCELERATION in every lane
+   */
+  static void BuildSpeedLimitProfile();
 
   static bool is_initialized_;
   static vector<double> map_waypoints_x_;
@@ -39,6 +96,37 @@ public:
   static vector<double> map_waypoints_s_;
   static vector<double> map_waypoints_dx_;
   static vector<double> map_waypoints_dy_;
+
+  //reference line sampled every REFERENCE_LINE_STEP meters of s starting from 0,
+  //normal points from reference line towards increasing d
+  static vector<double> reference_x_;
+  static vector<double> reference_y_;
+  static vector<double> reference_heading_;
+  static vector<double> reference_curvature_;
+  static vector<double> reference_normal_x_;
+  static vector<double> reference_normal_y_;
+
+  //lane centers and lane_boundaries_[lane] (left) to lane_boundaries_[lane + 1] (right)
+  static vector<double> lane_centers_;
+  static vector<double> lane_boundaries_;
+  //lane at start of each LANE_LOOKUP_STEP wide cell of d, a cell is narrower
+  //than any lane so d can only be in that lane or next one
+  static vector<int> lanes_by_cell_;
+
+  static vector<double> speed_limits_;
+
+  static const double MAX_LATERAL_ACCELERATION;
+  //deceleration used to slow down before a curve
+  static const double CURVE_DECELERATION;
+  //limit on straight road, where curvature gives none
+  static const double MAX_SPEED_LIMIT;
+  static const double LANE_LOOKUP_STEP;
+  static const double REFERENCE_LINE_STEP;
+  //waypoints are up to ~93 meters apart, closest point on reference line
+  //is within this distance (in s) of closest waypoint
+  static const double FRENET_SEARCH_DISTANCE;
+  // The max s value before wrapping around the track back to 0
+  static const double MAX_S;
 };
 
 #endif /* MAP_UTILS_H_ */
@@ -0,0 +1,141 @@
+/*
+ * occupancy_grid.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "occupancy_grid.h"
+
+OccupancyGrid::OccupancyGrid(double bin_size,
+                             double slice_duration,
+                             double horizon,
+                             double distance_behind,
+                             double distance_ahead)
+    : bin_size_(bin_size),
+      slice_duration_(slice_duration),
+      bins_count_((int) ceil((distance_behind + distance_ahead) / bin_size)),
+      slices_count_((int) ceil(horizon / slice_duration)),
+      words_per_bitset_((bins_count_ + 63) / 64),
+      distance_behind_(distance_behind) {
+  this->origin_s_ = 0;
+  this->lanes_count_ = 0;
+}
+
+OccupancyGrid::~OccupancyGrid() {
+}
+
+uint64_t *OccupancyGrid::Words(int lane, int slice) {
+  return &words_[(lane * slices_count_ + slice) * words_per_bitset_];
+}
+
+const uint64_t *OccupancyGrid::Words(int lane, int slice) const {
+  return &words_[(lane * slices_count_ + slice) * words_per_bitset_];
+}
+
+void OccupancyGrid::Build(const vector<Vehicle> &vehicles, double origin_s, double margin) {
+  origin_s_ = origin_s;
+
+  //only lanes that have vehicles in them need bitsets,
+  //any other lane is always clear
+  lanes_count_ = 0;
+  const int vehicles_count = vehicles.size();
+  for (int i = 0; i < vehicles_count; ++i) {
+    lanes_count_ = max(lanes_count_, vehicles[i].lane + 1);
+  }
+
+  //assign keeps capacity so rebuilding does not allocate after first cycles
+  words_.assign(lanes_count_ * slices_count_ * words_per_bitset_, 0);
+
+  for (int i = 0; i < vehicles_count; ++i) {
+    const Vehicle &vehicle = vehicles[i];
+    if (vehicle.lane < 0) {
+      continue;
+    }
+
+    for (int slice = 0; slice < slices_count_; ++slice) {
+      double start_t = slice * slice_duration_;
+      double end_t = start_t + slice_duration_;
+      double start_s = vehicle.s_at(start_t);
+      double end_s = vehicle.s_at(end_t);
+
+      //with acceleration vehicle can move past both ends of slice
+      //and come back (t*t/8 is max deviation from the chord),
+      //a millimeter is added against rounding of time at slice borders
+      double slack = fabs(vehicle.a) * slice_duration_ * slice_duration_ / 8 + 0.001;
+      MarkRange(vehicle.lane, slice, min(start_s, end_s) - margin - slack, max(start_s, end_s) + margin + slack);
+    }
+  }
+}
+
+void OccupancyGrid::MarkRange(int lane, int slice, double from_s, double to_s) {
+  int from_bin = (int) floor((from_s - origin_s_ + distance_behind_) / bin_size_);
+  int to_bin = (int) floor((to_s - origin_s_ + distance_behind_) / bin_size_);
+  from_bin = max(from_bin, 0);
+  to_bin = min(to_bin, bins_count_ - 1);
+
+  uint64_t *words = Words(lane, slice);
+  for (int bin = from_bin; bin <= to_bin; ++bin) {
+    words[bin >> 6] |= uint64_t(1) << (bin & 63);
+  }
+}
+
+bool OccupancyGrid::IsOccupied(int lane, double s, double t) const {
+  if (lane < 0 || lane >= lanes_count_) {
+    return false;
+  }
+
+  int slice = (int) floor(t / slice_duration_);
+  int bin = (int) floor((s - origin_s_ + distance_behind_) / bin_size_);
+  if (slice < 0 || slice >= slices_count_ || bin < 0 || bin >= bins_count_) {
+    //we don't know what is outside of grid
+    return true;
+  }
+
+  return (Words(lane, slice)[bin >> 6] >> (bin & 63)) & 1;
+}
+
+bool OccupancyGrid::IsRangeOccupied(int lane, double from_s, double to_s, double from_t, double to_t) const {
+  if (lane < 0 || lane >= lanes_count_) {
+    return false;
+  }
+
+  int from_slice = (int) floor(from_t / slice_duration_);
+  int to_slice = (int) floor(to_t / slice_duration_);
+  int from_bin = (int) floor((from_s - origin_s_ + distance_behind_) / bin_size_);
+  int to_bin = (int) floor((to_s - origin_s_ + distance_behind_) / bin_size_);
+  if (from_slice < 0 || to_slice >= slices_count_ || from_bin < 0 || to_bin >= bins_count_) {
+    //we don't know what is outside of grid
+    return true;
+  }
+
+  for (int slice = from_slice; slice <= to_slice; ++slice) {
+    const uint64_t *words = Words(lane, slice);
+    for (int bin = from_bin; bin <= to_bin; ++bin) {
+      if ((words[bin >> 6] >> (bin & 63)) & 1) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool OccupancyGrid::IsTrajectoryOccupied(const FrenetTrajectory &trajectory, int lane) const {
+  const int points_count = trajectory.s_values.size();
+  if (points_count == 1) {
+    return IsOccupied(lane, trajectory.s_values[0], 0);
+  }
+
+  for (int i = 0; i + 1 < points_count; ++i) {
+    double start_s = trajectory.s_values[i];
+    double end_s = trajectory.s_values[i + 1];
+    if (IsRangeOccupied(lane, min(start_s, end_s), max(start_s, end_s), i * 0.02, (i + 1) * 0.02)) {
+      return true;
+    }
+  }
+
+  return false;
+}
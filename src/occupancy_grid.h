@@ -0,0 +1,80 @@
+/*
+ * occupancy_grid.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef OCCUPANCY_GRID_H_
+#define OCCUPANCY_GRID_H_
+
+#include <stdint.h>
+#include <vector>
+#include "vehicle.h"
+#include "trajectory.h"
+
+using namespace std;
+
+/**
+ * Occupancy of road ahead and behind ego vehicle in Frenet space,
+ * one bitset over s-bins per lane and per time slice. It is built once
+ * per cycle from predicted states of other vehicles, after that asking
+ * whether any vehicle is near s in a lane at time t is a single bit test.
+ *
+ * Grid is conservative: a bin is marked if it overlaps the space a vehicle
+ * (inflated by margin) covers at any time within the slice, so a clear bin
+ * means there is definitely no vehicle within margin of that point.
+ * Anything outside the grid counts as occupied.
+ */
+class OccupancyGrid {
+public:
+  OccupancyGrid(double bin_size = 1.0,
+                double slice_duration = 0.1,
+                double horizon = 1.0,
+                double distance_behind = 100,
+                double distance_ahead = 200);
+  virtual ~OccupancyGrid();
+
+  /**
+   * Rebuilds the grid around origin_s from predicted vehicle positions
+   * (Vehicle::s_at), each vehicle covers [s - margin, s + margin] in its lane
+   */
+  void Build(const vector<Vehicle> &vehicles, double origin_s, double margin);
+
+  /**
+   * @returns true if a vehicle may be within margin of s in given lane at time t
+   */
+  bool IsOccupied(int lane, double s, double t) const;
+
+  /**
+   * @returns true if a vehicle may be within margin of any s in [from_s, to_s]
+   * in given lane at any time in [from_t, to_t]
+   */
+  bool IsRangeOccupied(int lane, double from_s, double to_s, double from_t, double to_t) const;
+
+  /**
+   * Checks trajectory in given lane, point i is at time i * 0.02 and ego vehicle
+   * moves linearly between points, so whole s range of each segment is checked
+   * @returns true if trajectory may come within margin of a vehicle
+   */
+  bool IsTrajectoryOccupied(const FrenetTrajectory &trajectory, int lane) const;
+
+private:
+  void MarkRange(int lane, int slice, double from_s, double to_s);
+  uint64_t *Words(int lane, int slice);
+  const uint64_t *Words(int lane, int slice) const;
+
+  const double bin_size_;
+  const double slice_duration_;
+  const int bins_count_;
+  const int slices_count_;
+  const int words_per_bitset_;
+  const double distance_behind_;
+
+  double origin_s_;
+  int lanes_count_;
+  //bitsets stored as [lane][slice][word]
+  vector<uint64_t> words_;
+};
+
+#endif /* OCCUPANCY_GRID_H_ */
@@ -0,0 +1,93 @@
+/*
+ * path_history.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include "path_history.h"
+
+PathHistory::PathHistory(int capacity) {
+  this->points_.resize(capacity);
+  this->head_ = 0;
+  this->size_ = 0;
+}
+
+PathHistory::~PathHistory() {
+}
+
+bool PathHistory::Align(const vector<double> &previous_path_x, const vector<double> &previous_path_y) {
+  PathEnds previous_path_ends;
+  previous_path_ends.size = previous_path_x.size();
+  if (previous_path_ends.size > 0) {
+    previous_path_ends.first_x = previous_path_x[0];
+    previous_path_ends.first_y = previous_path_y[0];
+    previous_path_ends.last_x = previous_path_x[previous_path_ends.size - 1];
+    previous_path_ends.last_y = previous_path_y[previous_path_ends.size - 1];
+  }
+
+  return Align(previous_path_ends);
+}
+
+bool PathHistory::Align(const PathEnds &previous_path_ends) {
+  if (!CanAlign(previous_path_ends)) {
+    Clear();
+    return false;
+  }
+
+  //Simulator removes points it has traversed from front of the path
+  //so drop the same number of points from front of history
+  const int consumed_count = size_ - previous_path_ends.size;
+  head_ = (head_ + consumed_count) % points_.size();
+  size_ = previous_path_ends.size;
+
+  return true;
+}
+
+bool PathHistory::CanAlign(const PathEnds &previous_path_ends) const {
+  const int previous_path_size = previous_path_ends.size;
+  if (previous_path_size == 0 || previous_path_size > size_) {
+    return false;
+  }
+
+  //make sure this is really the path we sent last time
+  const int consumed_count = size_ - previous_path_size;
+  return IsSamePoint((*this)[consumed_count], previous_path_ends.first_x, previous_path_ends.first_y)
+      && IsSamePoint((*this)[size_ - 1], previous_path_ends.last_x, previous_path_ends.last_y);
+}
+
+void PathHistory::Append(double x, double y, double s, double d) {
+  const int capacity = points_.size();
+  int tail = (head_ + size_) % capacity;
+
+  PathPoint &point = points_[tail];
+  point.x = x;
+  point.y = y;
+  point.s = s;
+  point.d = d;
+
+  if (size_ < capacity) {
+    ++size_;
+  } else {
+    //buffer is full, oldest point got overwritten
+    head_ = (head_ + 1) % capacity;
+  }
+}
+
+void PathHistory::Clear() {
+  head_ = 0;
+  size_ = 0;
+}
+
+int PathHistory::Size() const {
+  return size_;
+}
+
+const PathPoint &PathHistory::operator[](int i) const {
+  return points_[(head_ + i) % points_.size()];
+}
+
+bool PathHistory::IsSamePoint(const PathPoint &point, double x, double y) const {
+  return fabs(point.x - x) < MATCH_TOLERANCE && fabs(point.y - y) < MATCH_TOLERANCE;
+}
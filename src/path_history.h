@@ -0,0 +1,92 @@
+/*
+ * path_history.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PATH_HISTORY_H_
+#define PATH_HISTORY_H_
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * A point of a path sent to Simulator together with its Frenet coordinates
+ */
+struct PathPoint {
+  double x;
+  double y;
+  double s;
+  double d;
+};
+
+/**
+ * What is needed of previous path to line it up with points we sent,
+ * without having all of its points
+ */
+struct PathEnds {
+  int size;
+  double first_x;
+  double first_y;
+  double last_x;
+  double last_y;
+};
+
+/**
+ * Ring buffer of points emitted to Simulator. Simulator returns the
+ * not yet traversed part of our last path as previous path, so after
+ * dropping the consumed points from the front the buffer lines up with
+ * previous path point by point and its Frenet values can be reused.
+ */
+class PathHistory {
+public:
+  explicit PathHistory(int capacity = 128);
+  virtual ~PathHistory();
+
+  /**
+   * Drops points Simulator has already driven through so that remaining
+   * points correspond to given previous path. If they don't match (first
+   * cycle, Simulator restarted, etc.) history is cleared.
+   * @returns true if history is aligned with previous path
+   */
+  bool Align(const vector<double> &previous_path_x, const vector<double> &previous_path_y);
+
+  /**
+   * Same as above with only size and end points of previous path, remaining
+   * points of history then are the points of previous path
+   */
+  bool Align(const PathEnds &previous_path_ends);
+
+  /**
+   * @returns true if Align() would succeed, history is not changed
+   */
+  bool CanAlign(const PathEnds &previous_path_ends) const;
+
+  /**
+   * Adds a point at the end, overwrites oldest point if buffer is full
+   */
+  void Append(double x, double y, double s, double d);
+  void Clear();
+
+  int Size() const;
+
+  /**
+   * @param i index starting from oldest point in buffer
+   */
+  const PathPoint &operator[](int i) const;
+
+private:
+  bool IsSamePoint(const PathPoint &point, double x, double y) const;
+
+  vector<PathPoint> points_;
+  int head_;
+  int size_;
+
+  //previous path comes back from Simulator through JSON so
+  //points are compared with a small tolerance (in meters)
+  const double MATCH_TOLERANCE = 0.01;
+};
+
+#endif /* PATH_HISTORY_H_ */
@@ -5,55 +5,31 @@
  *      Author: ramiz
  */
 
+#include <algorithm>
 #include "map_utils.h"
 #include "path_planner.h"
+#include "constants.h"
 
 // Sensor Fusion Data, a list of all other cars on the same side of the road.
 //The data format for each car is: [ id, x, y, vx, vy, s, d]
-PathPlanner::PathPlanner() {
+PathPlanner::PathPlanner(PlannerMode mode)
+    : mode_(mode) {
   this->lane_ = 1;
   this->reference_velocity_ = 0.0;
+  this->reference_acceleration_ = 0.0;
+  this->braking_acceleration_ = 0.0;
 }
 
 //Sensor Fusion Data, a list of all other cars on the same side of the road.
 //The data format for each car is: [ id, x, y, vx, vy, s, d]'
-vector<Vehicle> PathPlanner::ExtractSensorFusionData(const vector<vector<double> > &sensor_fusion_data,
-                                                     const int previous_path_size) {
-
-  vector<Vehicle> vehicles;
-
-  for (int i = 0; i < sensor_fusion_data.size(); ++i) {
-    int id = sensor_fusion_data[i][0];
-    double x = sensor_fusion_data[i][1];
-    double y = sensor_fusion_data[i][2];
-
-    //access vx, vy which are at indexes (3, 4)
-    double vx = sensor_fusion_data[i][3];
-    double vy = sensor_fusion_data[i][4];
-
-    //s-coordinate is at index 5
-    double s = sensor_fusion_data[i][5];
-    //d-coordinate is at index 6
-    double d = sensor_fusion_data[i][6];
-
-    //calculate total velocity
-    double total_v = sqrt(vx*vx + vy*vy);
-
-    Vehicle vehicle(id, x, y, s, d, 0, total_v, 0);
-
-    //if previous_path size is not 0 that means
-    //the Simulator has not yet traversed complete prev path and
-    //the vehicle is not in perspective with the
-    //new path/trajectory we are going to build so
-    //we should predict its s-coordinate like if
-    //we previous path was already traversed
-    //REMEMBER: 1 timestep = 0.02 secs (or 20ms)
-    //    vehicle.increment(0.02 * previous_path_size);
-
-    vehicles.push_back(vehicle);
-  }
-
-  return vehicles;
+void PathPlanner::ExtractSensorFusionData(const vector<vector<double> > &sensor_fusion_data,
+                                          const double elapsed_time,
+                                          vector<Vehicle> &vehicles) {
+
+  //tracker remembers vehicles of previous cycles so it can
+  //estimate acceleration which sensor fusion does not give
+  vehicle_tracker_.Update(sensor_fusion_data, elapsed_time);
+  vehicle_tracker_.ExtractVehicles(vehicles);
 }
 
 void PathPlanner::UpdateEgoVehicleStateWithRespectToPreviousPath() {
@@ -88,36 +64,87 @@ PathPlanner::~PathPlanner() {
   // TODO Auto-generated destructor stub
 }
 
-double PathPlanner::FindDistanceFromVehicleAhead() {
-  //  int ego_vehicle_lane = MapUtils::GetLane(ego_vehicle_.d);
-  double min_distance = 999999;
-  double ego_vehicle_s = previous_path_x_.size() > 0 ? previous_path_last_s_: ego_vehicle_.s;
+bool PathPlanner::ParseMode(const string &name, PlannerMode &mode) {
+  if (name == "candidate_scoring") {
+    mode = CANDIDATE_SCORING;
+  } else if (name == "lattice") {
+    mode = LATTICE;
+  } else if (name == "jmt_sampling") {
+    mode = JMT_SAMPLING;
+  } else {
+    return false;
+  }
+  return true;
+}
 
-  for (int i = 0; i < vehicles_.size(); ++i) {
-    int vehicle_lane = vehicles_[i].lane;
-    double s = vehicles_[i].state_at(previous_path_x_.size() * 0.02)[1];
-    //discard this iteration if vehicle is not in ego_vehicle's lane
-    //and is not leading vehicle
+TrajectoryValues PathPlanner::PlanVelocities() {
+  const int prev_path_size = previous_path_x_.size();
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+
+  //profile starts where new points start, that is end of previous path
+  double start_s = prev_path_size > 0 ? previous_path_last_s_ : ego_vehicle_.s;
+  double start_t = prev_path_size * 0.02;
+  double start_v = reference_velocity_ * meters_per_second_in_mph;
+  //curve speed limits already leave room to slow down for curves ahead,
+  //so limit where profile starts is enough for the whole profile
+  double max_v = min(SPEED_LIMIT * meters_per_second_in_mph, MapUtils::GetSpeedLimit(start_s));
+  speed_optimizer_.Optimize(vehicles_, lane_, start_s, start_t, start_v, reference_acceleration_, max_v,
+                            PLANNED_MAX_ACCELERATION);
+
+  //sample profile at each new point, it already keeps velocity,
+  //acceleration and jerk within limits so points are taken as they are
+  const int new_points_count = max(0, TRAJECTORY_POINTS_COUNT - prev_path_size);
+  TrajectoryValues velocities = workspace_.MakeVector<double>(new_points_count);
+  double velocity = start_v;
+  for (int i = 1; i <= new_points_count; ++i) {
+    //never stand still, points must not be on top of each other
+    double next_velocity = max(0.1, speed_optimizer_.VelocityAt(i * 0.02));
+
+    reference_acceleration_ = (next_velocity - velocity) / 0.02;
+    velocity = next_velocity;
+    velocities.push_back(velocity / meters_per_second_in_mph);
+  }
 
-    if (vehicle_lane != this->lane_
-        || s <= ego_vehicle_s) {
-      //we are only interested in leading vehicles in same lane
-      continue;
-    }
+  if (new_points_count > 0) {
+    reference_velocity_ = velocities.back();
+  }
 
-    //vehicle is leading vehicle and in same lane as ego vehicle
-    //check distance to leading vehicle
-    double distance = s - ego_vehicle_s;
-    if (distance < min_distance) {
-      min_distance = distance;
-    }
+  return velocities;
+}
+
+TrajectoryValues PathPlanner::PlanBrakingVelocities() {
+  const int prev_path_size = previous_path_x_.size();
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+
+  //deceleration builds up from reference acceleration at
+  //Constants::MAX_JERK so that braking variant stays feasible
+  const int new_points_count = max(0, TRAJECTORY_POINTS_COUNT - prev_path_size);
+  TrajectoryValues velocities = workspace_.MakeVector<double>(new_points_count);
+  double velocity = reference_velocity_ * meters_per_second_in_mph;
+  double acceleration = reference_acceleration_;
+  for (int i = 1; i <= new_points_count; ++i) {
+    acceleration = max(-PLANNED_MAX_ACCELERATION, min(acceleration, 0.0) - Constants::MAX_JERK * 0.02);
+    //never stand still, points must not be on top of each other
+    double next_velocity = max(0.1, velocity + acceleration * 0.02);
+    acceleration = (next_velocity - velocity) / 0.02;
+    velocity = next_velocity;
+    velocities.push_back(velocity / meters_per_second_in_mph);
   }
+  braking_acceleration_ = acceleration;
 
-  return min_distance;
+  return velocities;
 }
 
-bool PathPlanner::IsTooCloseToVehicleAhead() {
-  return FindDistanceFromVehicleAhead() < BUFFER_DISTANCE;
+ArenaVector<TrajectoryValues> PathPlanner::PlanVelocityVariants() {
+  //braking variant starts from same reference velocity, so it
+  //is planned before PlanVelocities() moves that to end of new points
+  TrajectoryValues braking_velocities = PlanBrakingVelocities();
+
+  ArenaVector<TrajectoryValues> velocity_variants = workspace_.MakeVector<TrajectoryValues>(2);
+  velocity_variants.push_back(PlanVelocities());
+  velocity_variants.push_back(std::move(braking_velocities));
+
+  return velocity_variants;
 }
 
 CartesianTrajectory PathPlanner::GenerateTrajectory(const Vehicle &ego_vehicle,
@@ -126,115 +153,519 @@ CartesianTrajectory PathPlanner::GenerateTrajectory(const Vehicle &ego_vehicle,
                                            const vector<double> &previous_path_y,
                                            const double previous_path_last_s,
                                            const double previous_path_last_d) {
-  this->ego_vehicle_ = ego_vehicle;
   this->previous_path_x_ = previous_path_x;
   this->previous_path_y_ = previous_path_y;
-  this->previous_path_last_s_ = previous_path_last_s;
-  this->previous_path_last_d_ = previous_path_last_d;
 
-  this->vehicles_ = ExtractSensorFusionData(sensor_fusion_data, previous_path_x.size());
+  //drop points Simulator has already traversed from our record of
+  //sent path so that it matches previous path point by point
+  const int sent_points_count = path_history_.Size();
+  bool is_aligned = path_history_.Align(previous_path_x, previous_path_y);
 
-  //we need to consider whether Simulator has traversed previous path
-  //completely or some points till left. This will affect ego vehicle
-  //state as well as new path so let's update ego vehicle state accordingly
-//  UpdateEgoVehicleStateWithRespectToPreviousPath();
+  //Simulator drives through one point every 0.02 secs so points it
+  //consumed since last cycle tell how much time has passed
+  double elapsed_time = is_aligned ? (sent_points_count - path_history_.Size()) * 0.02 : 0;
+  return PlanCycle(ego_vehicle, sensor_fusion_data, elapsed_time, previous_path_last_s, previous_path_last_d);
+}
 
-  bool is_too_close_to_leading_vehicle = IsTooCloseToVehicleAhead();
+CartesianTrajectory PathPlanner::GenerateTrajectory(const Vehicle &ego_vehicle,
+                                           const vector<vector<double> > &sensor_fusion_data,
+                                           const PathEnds &previous_path_ends,
+                                           const double previous_path_last_s,
+                                           const double previous_path_last_d) {
+  const int sent_points_count = path_history_.Size();
+  bool is_aligned = path_history_.Align(previous_path_ends);
+
+  //previous path is what is left of the path we sent, so its
+  //points are taken from our record instead of from Simulator
+  previous_path_x_.clear();
+  previous_path_y_.clear();
+  for (int i = 0; is_aligned && i < path_history_.Size(); ++i) {
+    previous_path_x_.push_back(path_history_[i].x);
+    previous_path_y_.push_back(path_history_[i].y);
+  }
+
+  double elapsed_time = is_aligned ? (sent_points_count - path_history_.Size()) * 0.02 : 0;
+  return PlanCycle(ego_vehicle, sensor_fusion_data, elapsed_time, previous_path_last_s, previous_path_last_d);
+}
 
-  if (is_too_close_to_leading_vehicle) {
-    //decrease speed to avoid collision
-    this->reference_velocity_ -= 0.224;
+bool PathPlanner::IsEmittedPath(const PathEnds &previous_path_ends) const {
+  return path_history_.CanAlign(previous_path_ends);
+}
 
-    //also consider changing lanes
-//    this->lane_ = (this->lane_ + 1) % 3;
-  } else if (reference_velocity_ < SPEED_LIMIT) {
-    //we have less than desired speed and
-    //are more than buffer distance from leading vehicle
-    //so that means we can increase speed
-    this->reference_velocity_ += 0.224;
+void PathPlanner::PrecomputeNextCycle() {
+  //whatever Simulator drives through until next telemetry, previous
+  //path will still end where path we sent ends. Splines of lanes we
+  //may go to next start there, so they can be fitted now
+  //other modes don't use lane splines
+  const int sent_points_count = path_history_.Size();
+  if (mode_ != CANDIDATE_SCORING || sent_points_count < 2) {
+    return;
+  }
+  sent_path_end_x_.clear();
+  sent_path_end_y_.clear();
+  for (int i = sent_points_count - 2; i < sent_points_count; ++i) {
+    sent_path_end_x_.push_back(path_history_[i].x);
+    sent_path_end_y_.push_back(path_history_[i].y);
+  }
+  const PathPoint &last_point = path_history_[sent_points_count - 1];
+
+  //gaps are checked again with new sensor fusion data, so all
+  //neighbor lanes are prepared here. Lanes live in workspace
+  //until next cycle begins, which is when they are used
+  ArenaVector<int> lanes = workspace_.MakeVector<int>(3);
+  lanes.push_back(lane_);
+  if (lane_ > 0) {
+    lanes.push_back(lane_ - 1);
+  }
+  if (lane_ < MapUtils::LanesCount() - 1) {
+    lanes.push_back(lane_ + 1);
   }
 
+  trajectory_generator_.PrecomputeSplines(ego_vehicle_, sent_path_end_x_, sent_path_end_y_, last_point.s,
+                                          last_point.d, lanes);
+}
 
-////  stay in current lane
-//   CartesianTrajectory trajectory = trajectory_generator_.GenerateTrajectory(ego_vehicle_, previous_path_x, previous_path_y, previous_path_last_s,
-//          previous_path_last_d, lane_, reference_velocity_);
-//
-//      return trajectory;
+CartesianTrajectory PathPlanner::PlanCycle(const Vehicle &ego_vehicle,
+                                           const vector<vector<double> > &sensor_fusion_data,
+                                           const double elapsed_time,
+                                           const double previous_path_last_s,
+                                           const double previous_path_last_d) {
+  //everything allocated in workspace during last cycle is released here
+  workspace_.BeginCycle();
+  //grid and index of last cycle were built for vehicles that are about to change
+  cost_functions_.BeginCycle();
 
-  CartesianTrajectory trajectory = FindBestTrajectory();
-  return trajectory.ExtractTrajectory();
-}
+  this->ego_vehicle_ = ego_vehicle;
+  this->previous_path_last_s_ = previous_path_last_s;
+  this->previous_path_last_d_ = previous_path_last_d;
 
-vector<CartesianTrajectory> PathPlanner::GeneratePossibleTrajectories(const vector<int> &valid_lanes) {
-  //find trajectories for valid lanes
-  vector<CartesianTrajectory> trajectories;
+  ExtractSensorFusionData(sensor_fusion_data, elapsed_time, this->vehicles_);
+  cost_functions_.BuildOccupancyGrid(vehicles_, ego_vehicle_.s);
+  cost_functions_.BuildGapIndex(vehicles_);
 
-  const int lanes_count = valid_lanes.size();
-  for (int i = 0; i < lanes_count; ++i) {
-    int proposed_lane = valid_lanes[i];
+  //we need to consider whether Simulator has traversed previous path
+  //completely or some points till left. This will affect ego vehicle
+  //state as well as new path so let's update ego vehicle state accordingly
+//  UpdateEgoVehicleStateWithRespectToPreviousPath();
 
-    //generate trajectory for this lane
-    CartesianTrajectory trajectory = trajectory_generator_.GenerateTrajectory(
-        ego_vehicle_, previous_path_x_, previous_path_y_, previous_path_last_s_,
-        previous_path_last_d_, proposed_lane, reference_velocity_);
-    trajectories.push_back(trajectory);
-  }
+  //instead of one velocity for whole path each new point gets its own
+  //from a smooth profile that keeps distance from vehicles ahead. Candidates
+  //are also scored with a braking profile in case planned one still collides
+  ArenaVector<TrajectoryValues> velocity_variants = PlanVelocityVariants();
+
+  CartesianTrajectory trajectory = mode_ == LATTICE ? FindLatticeTrajectory(velocity_variants[0])
+                                   : mode_ == JMT_SAMPLING ? FindJMTTrajectory()
+                                   : FindBestTrajectory(velocity_variants);
+  return trajectory.ExtractTrajectory(TRAJECTORY_POINTS_COUNT);
+}
 
-  return trajectories;
+ArenaVector<CartesianTrajectory> PathPlanner::GeneratePossibleTrajectories(const ArenaVector<int> &valid_lanes,
+                                                                           const ArenaVector<TrajectoryValues> &velocity_variants) {
+  //find trajectories for valid lanes and velocity variants, all of them in
+  //one go as they share everything except the spline they follow, and
+  //variants of a lane share its spline too
+  return trajectory_generator_.GenerateTrajectories(ego_vehicle_, previous_path_x_, previous_path_y_,
+                                                    previous_path_last_s_, previous_path_last_d_, valid_lanes,
+                                                    velocity_variants, workspace_);
 }
 
-vector<int> PathPlanner::GetPossibleLanesToGo() {
+ArenaVector<int> PathPlanner::GetPossibleLanesToGo() {
   //filter out valid lanes to go to
-  vector<int> valid_lanes = { lane_ };
-  if (lane_ == 0) {
-    //we only want to change one lane at a time
-    valid_lanes.push_back(1);
-  } else if (lane_ == 2) {
-    //we only want to change one lane at a time
-    valid_lanes.push_back(1);
-  } else if (lane_ == 1) {
-    //we can either go left lane or right lane
-    valid_lanes.push_back(0);
-    valid_lanes.push_back(2);
+  ArenaVector<int> valid_lanes = workspace_.MakeVector<int>(3);
+  valid_lanes.push_back(lane_);
+  //we only want to change one lane at a time,
+  //to left or right lane if road has them
+  if (lane_ > 0 && IsLaneChangeGapViable(lane_ - 1)) {
+    valid_lanes.push_back(lane_ - 1);
+  }
+  if (lane_ < MapUtils::LanesCount() - 1 && IsLaneChangeGapViable(lane_ + 1)) {
+    valid_lanes.push_back(lane_ + 1);
   }
 
   return valid_lanes;
 }
 
-CartesianTrajectory PathPlanner::FindBestTrajectory() {
+bool PathPlanner::IsLaneChangeGapViable(int lane) {
+  //new points start at end of previous path, a vehicle next to ego vehicle
+  //there or when it has moved over is a sure collision and no trajectory
+  //has to be generated to find that out
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  const int prev_path_size = previous_path_x_.size();
+  double start_s = prev_path_size > 0 ? previous_path_last_s_ : ego_vehicle_.s;
+  double start_t = prev_path_size * 0.02;
+  double end_s = start_s + reference_velocity_ * meters_per_second_in_mph * LANE_CHANGE_DURATION;
+  double end_t = start_t + LANE_CHANGE_DURATION;
+
+  const GapIndex &gap_index = cost_functions_.GetGapIndex();
+  return gap_index.IsGapViable(lane, start_s, start_t, MIN_LANE_CHANGE_GAP, MIN_LANE_CHANGE_GAP)
+      && gap_index.IsGapViable(lane, end_s, end_t, MIN_LANE_CHANGE_GAP, MIN_LANE_CHANGE_GAP);
+}
+
+bool PathPlanner::IsJMTGoalGapViable(int lane, double goal_s, double goal_v, double t) {
+  const GapIndex &gap_index = cost_functions_.GetGapIndex();
+  Gap gap = gap_index.FindGap(lane, goal_s, t);
+  if (gap.follower_index != -1 && gap.follower_s > goal_s - MIN_LANE_CHANGE_GAP) {
+    return false;
+  }
+  if (gap.leader_index == -1) {
+    return true;
+  }
+
+  //JMT ends at goal velocity, after that we still have to be able to
+  //slow down to velocity of vehicle ahead
+  double closing_v = max(0.0, goal_v - gap.leader_v);
+  double braking_distance = closing_v * closing_v / (2 * PLANNED_MAX_ACCELERATION);
+  return gap.leader_s - goal_s >= JMT_FOLLOW_DISTANCE + braking_distance;
+}
+
+CartesianTrajectory PathPlanner::FindBestTrajectory(const ArenaVector<TrajectoryValues> &velocity_variants) {
+
+  //search maneuver sequences a few seconds ahead, a lane which is not
+  //better right now may be the first step of a better overtake
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  behavior_search_.Search(vehicles_, ego_vehicle_.s, reference_velocity_ * meters_per_second_in_mph,
+                          lane_, MapUtils::LanesCount(), SPEED_LIMIT * meters_per_second_in_mph);
 
   //filter out valid lanes to go to
-  vector<int> valid_lanes = GetPossibleLanesToGo();
+  ArenaVector<int> valid_lanes = GetPossibleLanesToGo();
   cout << "\n\n--current lane is " << lane_ << " and next valid lanes are: " << endl;
   Utils::print_vector(valid_lanes);
   //find possible lanes to go on
-  vector<CartesianTrajectory> possible_trajectories  = GeneratePossibleTrajectories(valid_lanes);
+  ArenaVector<CartesianTrajectory> possible_trajectories  = GeneratePossibleTrajectories(valid_lanes, velocity_variants);
+  const int variants_count = velocity_variants.size();
+
+  //all trajectories start with previous path points whose Frenet
+  //values we already know from last cycle, so only new points need conversion
+  TrajectoryValues known_s_values = workspace_.MakeVector<double>(path_history_.Size());
+  TrajectoryValues known_d_values = workspace_.MakeVector<double>(path_history_.Size());
+  ExtractKnownFrenetValues(known_s_values, known_d_values);
+
+  //check speed, acceleration and jerk of candidates first, from some points
+  //before new ones start so that joint with previous path is covered too
+  const int trajectories_count = possible_trajectories.size();
+  const int first_checked_point = max(0, path_history_.Size() - FeasibilityValidator::CONTEXT_POINTS_COUNT);
+  ArenaVector<Feasibility> feasibilities = workspace_.MakeVector<Feasibility>(trajectories_count);
+  bool is_any_feasible = false;
+  for (int i = 0; i < trajectories_count; ++i) {
+    feasibilities.push_back(feasibility_validator_.Validate(possible_trajectories[i], first_checked_point));
+    is_any_feasible = is_any_feasible || feasibilities[i].IsFeasible();
+  }
 
   //now find min cost trajectory out of these possible trajectories
   int best_trajectory_index = -1;
+  int best_frenet_trajectory_index = -1;
   double min_cost = 999999;
 
-  const int trajectories_count = possible_trajectories.size();
+  ArenaVector<FrenetTrajectory> frenet_trajectories = workspace_.MakeVector<FrenetTrajectory>(trajectories_count);
   for (int i = 0; i < trajectories_count; ++i) {
     cout << "----------Considering trajectory for lane: " << possible_trajectories[i].lane << "----------"<< endl;
 
-    double cost = cost_functions_.CalculateCost(ego_vehicle_, vehicles_, possible_trajectories[i], this->lane_);
+    //infeasible ones are skipped before expensive Frenet conversion and
+    //costs, unless all of them are infeasible and we still need a trajectory
+    const Feasibility &feasibility = feasibilities[i];
+    if (is_any_feasible && !feasibility.IsFeasible()) {
+      printf("---lane %d is infeasible, max speed %f, acceleration %f, jerk %f\n", possible_trajectories[i].lane,
+             feasibility.max_speed, feasibility.max_acceleration, feasibility.max_jerk);
+      continue;
+    }
+
+    frenet_trajectories.push_back(MapUtils::CartesianToFrenet(possible_trajectories[i], ego_vehicle_.yaw,
+                                                              known_s_values, known_d_values));
+
+    double cost = cost_functions_.CalculateCost(ego_vehicle_, vehicles_, frenet_trajectories.back(), this->lane_);
+    cost += LOOKAHEAD_COST_WEIGHT * behavior_search_.Regret(possible_trajectories[i].lane);
+    //every variant other than planned one is braking variant
+    bool is_braking = i % variants_count != 0;
+    if (is_braking) {
+      cost += BRAKING_VARIANT_COST;
+    }
     printf("---cost of lane %d is %f\n", possible_trajectories[i].lane, cost);
 
     if (cost < min_cost) {
       min_cost = cost;
       best_trajectory_index = i;
+      best_frenet_trajectory_index = frenet_trajectories.size() - 1;
     }
   }
 
-  CartesianTrajectory best_trajectory = possible_trajectories[best_trajectory_index];
+  CartesianTrajectory &best_trajectory = possible_trajectories[best_trajectory_index];
 
   printf("selected lane %d with cost %f\n", best_trajectory.lane, min_cost);
+  //next cycle continues from end of braking profile if that won
+  if (best_trajectory_index % variants_count != 0) {
+    cout << "Braking variant selected" << endl;
+    reference_velocity_ = best_trajectory.reference_velocity;
+    reference_acceleration_ = braking_acceleration_;
+  }
+  if (this->lane_ != best_trajectory.lane) {
+    cerr << "Lane change occurred" << endl;
+  }
+  this->lane_ = best_trajectory.lane;
+
+  UpdatePathHistory(best_trajectory, frenet_trajectories[best_frenet_trajectory_index]);
+
+  return std::move(best_trajectory);
+}
+
+void PathPlanner::ExtractKnownFrenetValues(TrajectoryValues &known_s_values, TrajectoryValues &known_d_values) {
+  const int known_count = path_history_.Size();
+  for (int i = 0; i < known_count; ++i) {
+    known_s_values.push_back(path_history_[i].s);
+    known_d_values.push_back(path_history_[i].d);
+  }
+}
+
+CartesianTrajectory PathPlanner::FindLatticeTrajectory(const TrajectoryValues &velocities) {
+  //lattice starts where new path starts, same as in TrajectoryGenerator
+  const bool has_previous_path = previous_path_x_.size() >= 2;
+  double start_s = has_previous_path ? previous_path_last_s_ : ego_vehicle_.s;
+  double start_d = has_previous_path ? previous_path_last_d_ : ego_vehicle_.d;
+
+  //vehicle predictions are in time from now, so lattice time
+  //starts after ego vehicle has traversed previous path
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  double start_t = previous_path_x_.size() * 0.02;
+  //lattice path may only end in lanes whose gap lets us move in, same
+  //ones other modes consider. They are lane_ and its viable neighbors
+  ArenaVector<int> valid_lanes = GetPossibleLanesToGo();
+  const int min_end_lane = *min_element(valid_lanes.begin(), valid_lanes.end());
+  const int max_end_lane = *max_element(valid_lanes.begin(), valid_lanes.end());
+  lattice_planner_.Plan(vehicles_, start_s, start_d, start_t,
+                        max(reference_velocity_, 1.0) * meters_per_second_in_mph, MapUtils::LanesCount(),
+                        lane_, min_end_lane, max_end_lane);
+
+  //cheapest lattice path becomes anchors of smoothing spline
+  const int stations_count = lattice_planner_.StationsCount();
+  TrajectoryValues anchor_s_offsets = workspace_.MakeVector<double>(stations_count);
+  TrajectoryValues anchor_d_values = workspace_.MakeVector<double>(stations_count);
+  for (int station = 0; station < stations_count; ++station) {
+    anchor_s_offsets.push_back(lattice_planner_.StationOffset(station));
+    anchor_d_values.push_back(lattice_planner_.PathD(station));
+  }
+
+  //lane we are heading to is the one the lattice path ends in
+  int target_lane = MapUtils::GetLane(anchor_d_values[stations_count - 1]);
+  CartesianTrajectory lattice_trajectory = trajectory_generator_.GenerateTrajectory(
+      ego_vehicle_, previous_path_x_, previous_path_y_, previous_path_last_s_, previous_path_last_d_,
+      anchor_s_offsets, anchor_d_values, target_lane, velocities, workspace_);
+
+  //smoothed lattice path is checked like candidates of other modes, from some
+  //points before new ones start. A lane change over speed, acceleration or
+  //jerk limits is replaced by keeping lane_, unless that is infeasible too
+  const int first_checked_point = max(0, path_history_.Size() - FeasibilityValidator::CONTEXT_POINTS_COUNT);
+  Feasibility feasibility = feasibility_validator_.Validate(lattice_trajectory, first_checked_point);
+  if (!feasibility.IsFeasible() && target_lane != lane_) {
+    CartesianTrajectory keep_lane_trajectory = trajectory_generator_.GenerateTrajectory(
+        ego_vehicle_, previous_path_x_, previous_path_y_, previous_path_last_s_, previous_path_last_d_,
+        lane_, velocities, workspace_);
+    if (feasibility_validator_.Validate(keep_lane_trajectory, first_checked_point).IsFeasible()) {
+      printf("---lattice lane change to %d is infeasible, max speed %f, acceleration %f, jerk %f\n", target_lane,
+             feasibility.max_speed, feasibility.max_acceleration, feasibility.max_jerk);
+      return SelectLatticeTrajectory(keep_lane_trajectory);
+    }
+  }
+
+  return SelectLatticeTrajectory(lattice_trajectory);
+}
+
+CartesianTrajectory PathPlanner::SelectLatticeTrajectory(CartesianTrajectory &trajectory) {
+  if (this->lane_ != trajectory.lane) {
+    cerr << "Lane change occurred" << endl;
+  }
+  this->lane_ = trajectory.lane;
+
+  TrajectoryValues known_s_values = workspace_.MakeVector<double>(path_history_.Size());
+  TrajectoryValues known_d_values = workspace_.MakeVector<double>(path_history_.Size());
+  ExtractKnownFrenetValues(known_s_values, known_d_values);
+  FrenetTrajectory frenet_trajectory = MapUtils::CartesianToFrenet(trajectory, ego_vehicle_.yaw,
+                                                                   known_s_values, known_d_values);
+
+  UpdatePathHistory(trajectory, frenet_trajectory);
+
+  return std::move(trajectory);
+}
+
+CartesianTrajectory PathPlanner::FindJMTTrajectory() {
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  behavior_search_.Search(vehicles_, ego_vehicle_.s, reference_velocity_ * meters_per_second_in_mph,
+                          lane_, MapUtils::LanesCount(), SPEED_LIMIT * meters_per_second_in_mph);
+  ArenaVector<int> valid_lanes = GetPossibleLanesToGo();
+
+  //Frenet values of previous path, known ones are taken from history
+  const int prev_path_size = previous_path_x_.size();
+  TrajectoryValues known_s_values = workspace_.MakeVector<double>(path_history_.Size());
+  TrajectoryValues known_d_values = workspace_.MakeVector<double>(path_history_.Size());
+  ExtractKnownFrenetValues(known_s_values, known_d_values);
+  TrajectoryValues previous_x_values = workspace_.MakeVector<double>(prev_path_size);
+  TrajectoryValues previous_y_values = workspace_.MakeVector<double>(prev_path_size);
+  previous_x_values.insert(previous_x_values.end(), previous_path_x_.begin(), previous_path_x_.end());
+  previous_y_values.insert(previous_y_values.end(), previous_path_y_.begin(), previous_path_y_.end());
+  CartesianTrajectory previous_path(std::move(previous_x_values), std::move(previous_y_values),
+                                    reference_velocity_, lane_);
+  FrenetTrajectory previous_frenet(workspace_.MakeVector<double>(), workspace_.MakeVector<double>(),
+                                   reference_velocity_, lane_);
+  if (prev_path_size > 0) {
+    previous_frenet = MapUtils::CartesianToFrenet(previous_path, ego_vehicle_.yaw, known_s_values, known_d_values);
+  }
+
+  //goals are JMT_HORIZON secs ahead in center of each lane, with velocity
+  //speed optimizer planned and ones sampled between what
+  //PLANNED_MAX_ACCELERATION allows to reach by then. Velocity of such a JMT
+  //follows a cubic whose peak acceleration is 1.5 times its average one, and
+  //peak jerk then stays within Constants::MAX_JERK. Sampled ones must leave
+  //room behind vehicle ahead, feasibility validator cuts the ones JMT can't
+  //reach within Constants::MAX_ACCELERATION
+  Vector3d start_s;
+  Vector3d start_d;
+  EstimateFrenetState(previous_frenet, start_s, start_d);
+  const double max_v = min(SPEED_LIMIT * meters_per_second_in_mph, MapUtils::GetSpeedLimit(start_s[0]));
+  const double reachable_dv = PLANNED_MAX_ACCELERATION * JMT_HORIZON / 1.5;
+  const double highest_goal_v = max(0.1, min(max_v, start_s[1] + reachable_dv));
+  const double lowest_goal_v = max(0.1, min(highest_goal_v, start_s[1] - reachable_dv));
+  ArenaVector<double> goal_velocities = workspace_.MakeVector<double>(JMT_GOAL_VELOCITIES_COUNT + 1);
+  goal_velocities.push_back(max(0.1, min(speed_optimizer_.VelocityAt(JMT_HORIZON), max_v)));
+  for (int i = 0; i < JMT_GOAL_VELOCITIES_COUNT; ++i) {
+    goal_velocities.push_back(lowest_goal_v
+        + (highest_goal_v - lowest_goal_v) * i / (JMT_GOAL_VELOCITIES_COUNT - 1));
+  }
+
+  //new points are taken from beginning of each JMT, after previous path
+  const int new_points_count = max(0, TRAJECTORY_POINTS_COUNT - prev_path_size);
+  const int first_checked_point = max(0, path_history_.Size() - FeasibilityValidator::CONTEXT_POINTS_COUNT);
+  const int lanes_count = valid_lanes.size();
+  const int goals_count = lanes_count * goal_velocities.size();
+  //only planned goal is perturbed, sampled velocities already spread the others
+  const int jmts_count = lanes_count * (Constants::N_SAMPLES + goal_velocities.size());
+  ArenaVector<CartesianTrajectory> trajectories = workspace_.MakeVector<CartesianTrajectory>(jmts_count);
+  ArenaVector<FrenetTrajectory> frenet_trajectories = workspace_.MakeVector<FrenetTrajectory>(jmts_count);
+  ArenaVector<double> costs = workspace_.MakeVector<double>(jmts_count);
+  ArenaVector<bool> feasible = workspace_.MakeVector<bool>(jmts_count);
+  bool is_any_feasible = false;
+  for (int goal_index = 0; goal_index < goals_count; ++goal_index) {
+    const int lane = valid_lanes[goal_index / goal_velocities.size()];
+    const bool is_planned_goal = goal_index % goal_velocities.size() == 0;
+    const double goal_v = goal_velocities[goal_index % goal_velocities.size()];
+    Vector3d goal_s(start_s[0] + (start_s[1] + goal_v) / 2 * JMT_HORIZON, goal_v, 0);
+    if (!is_planned_goal && !IsJMTGoalGapViable(lane, goal_s[0], goal_v, prev_path_size * 0.02 + JMT_HORIZON)) {
+      continue;
+    }
+    Vector3d goal_d(MapUtils::GetdValueForLaneCenter(lane), 0, 0);
+    ArenaVector<FrenetTrajectory> jmts = is_planned_goal
+        ? jmt_trajectory_generator_.GeneratePerturbedTrajectories(start_s, start_d, goal_s, goal_d,
+                                                                  JMT_HORIZON, lane, workspace_)
+        : workspace_.MakeVector<FrenetTrajectory>(1);
+    if (!is_planned_goal) {
+      jmts.push_back(jmt_trajectory_generator_.GenerateTrajectory(start_s, start_d, goal_s, goal_d,
+                                                                  JMT_HORIZON, lane, workspace_));
+    }
+
+    for (int i = 0; i < jmts.size(); ++i) {
+      //whole JMT is scored after previous path, only its first points are sent
+      const FrenetTrajectory &jmt = jmts[i];
+      TrajectoryValues s_values = workspace_.MakeVector<double>(prev_path_size + jmt.s_values.size());
+      TrajectoryValues d_values = workspace_.MakeVector<double>(prev_path_size + jmt.s_values.size());
+      s_values.insert(s_values.end(), previous_frenet.s_values.begin(), previous_frenet.s_values.end());
+      d_values.insert(d_values.end(), previous_frenet.d_values.begin(), previous_frenet.d_values.end());
+      s_values.insert(s_values.end(), jmt.s_values.begin(), jmt.s_values.end());
+      d_values.insert(d_values.end(), jmt.d_values.begin(), jmt.d_values.end());
+      frenet_trajectories.push_back(FrenetTrajectory(std::move(s_values), std::move(d_values),
+                                                     jmt.reference_velocity, lane));
+
+      TrajectoryValues x_values = workspace_.MakeVector<double>(prev_path_size + new_points_count);
+      TrajectoryValues y_values = workspace_.MakeVector<double>(prev_path_size + new_points_count);
+      x_values.insert(x_values.end(), previous_path_x_.begin(), previous_path_x_.end());
+      y_values.insert(y_values.end(), previous_path_y_.begin(), previous_path_y_.end());
+      for (int point = 0; point < new_points_count && point < jmt.s_values.size(); ++point) {
+        double x;
+        double y;
+        MapUtils::getXY(fmod(jmt.s_values[point], MAX_S), jmt.d_values[point], x, y);
+        x_values.push_back(x);
+        y_values.push_back(y);
+      }
+      trajectories.push_back(CartesianTrajectory(std::move(x_values), std::move(y_values),
+                                                 jmt.reference_velocity, lane));
+
+      //perturbed goals may be behind start, vehicle can't back up
+      bool is_feasible = jmt.s_values.back() > start_s[0]
+          && feasibility_validator_.Validate(trajectories.back(), first_checked_point).IsFeasible();
+      feasible.push_back(is_feasible);
+      is_any_feasible = is_any_feasible || is_feasible;
+
+      //cost functions alone favor goals which stay back from vehicle ahead,
+      //so velocity given up and how far goal was perturbed are charged for too
+      double cost = cost_functions_.CalculateCost(ego_vehicle_, vehicles_, frenet_trajectories.back(), this->lane_);
+      cost += LOOKAHEAD_COST_WEIGHT * behavior_search_.Regret(lane);
+      cost += JMT_SPEED_COST_WEIGHT * (max_v - goal_v) / max_v;
+      const int last = jmt.s_values.size() - 1;
+      double end_velocity = (jmt.s_values[last] - jmt.s_values[last - 1]) / 0.02;
+      cost += JMT_GOAL_COST_WEIGHT * (Utils::logistic(fabs(jmt.s_values[last] - goal_s[0]) / Constants::SIGMA_S[0])
+          + Utils::logistic(fabs(end_velocity - goal_s[1]) / Constants::SIGMA_S[1]));
+      costs.push_back(cost);
+    }
+  }
+
+  //infeasible ones only count if all of them are
+  int best_index = 0;
+  double min_cost = 999999;
+  for (int i = 0; i < trajectories.size(); ++i) {
+    if ((feasible[i] || !is_any_feasible) && costs[i] < min_cost) {
+      min_cost = costs[i];
+      best_index = i;
+    }
+  }
+
+  CartesianTrajectory &best_trajectory = trajectories[best_index];
+  const FrenetTrajectory &best_frenet_trajectory = frenet_trajectories[best_index];
+  printf("selected JMT of lane %d with cost %f\n", best_trajectory.lane, min_cost);
   if (this->lane_ != best_trajectory.lane) {
     cerr << "Lane change occurred" << endl;
   }
   this->lane_ = best_trajectory.lane;
-  return best_trajectory;
+
+  //speed optimizer of next cycle starts from where sent JMT points end
+  const int last_point = best_trajectory.x_values.size() - 1;
+  if (new_points_count > 0 && last_point >= 2) {
+    const TrajectoryValues &s_values = best_frenet_trajectory.s_values;
+    double velocity = (s_values[last_point] - s_values[last_point - 1]) / 0.02;
+    double previous_velocity = (s_values[last_point - 1] - s_values[last_point - 2]) / 0.02;
+    reference_velocity_ = velocity / meters_per_second_in_mph;
+    reference_acceleration_ = (velocity - previous_velocity) / 0.02;
+  }
+
+  UpdatePathHistory(best_trajectory, best_frenet_trajectory);
+
+  return std::move(best_trajectory);
+}
+
+void PathPlanner::EstimateFrenetState(const FrenetTrajectory &previous_path, Vector3d &state_s, Vector3d &state_d) {
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  const int size = previous_path.s_values.size();
+  if (size < 3) {
+    state_s << ego_vehicle_.s, ego_vehicle_.v * meters_per_second_in_mph, 0;
+    state_d << ego_vehicle_.d, 0, 0;
+    return;
+  }
+
+  //s of last points is made continuous in case path wraps around the track
+  const TrajectoryValues &s = previous_path.s_values;
+  const TrajectoryValues &d = previous_path.d_values;
+  double s2 = s[size - 1];
+  double s1 = s2 - fmod(s2 - s[size - 2] + 1.5 * MAX_S, MAX_S) + 0.5 * MAX_S;
+  double s0 = s1 - fmod(s1 - s[size - 3] + 1.5 * MAX_S, MAX_S) + 0.5 * MAX_S;
+  state_s << s2, (s2 - s1) / 0.02, (s2 - 2 * s1 + s0) / (0.02 * 0.02);
+  state_d << d[size - 1], (d[size - 1] - d[size - 2]) / 0.02,
+      (d[size - 1] - 2 * d[size - 2] + d[size - 3]) / (0.02 * 0.02);
+}
+
+void PathPlanner::UpdatePathHistory(const CartesianTrajectory &trajectory,
+                                    const FrenetTrajectory &frenet_trajectory) {
+  //history already contains previous path points which
+  //trajectory starts with, so only add newly generated points
+  const int points_count = min((int) trajectory.x_values.size(), TRAJECTORY_POINTS_COUNT);
+  for (int i = path_history_.Size(); i < points_count; ++i) {
+    path_history_.Append(trajectory.x_values[i], trajectory.y_values[i],
+                         frenet_trajectory.s_values[i], frenet_trajectory.d_values[i]);
+  }
 }
 
 
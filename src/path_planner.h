@@ -9,22 +9,53 @@
 #define PATH_PLANNER_H_
 
 #include <iostream>
+#include <string>
 #include <vector>
 #include "vehicle.h"
 #include "trajectory_generator.h"
 #include "trajectory.h"
 #include "cost_functions.h"
+#include "planner_workspace.h"
+#include "path_history.h"
+#include "behavior_search.h"
+#include "lattice_planner.h"
+#include "speed_optimizer.h"
+#include "vehicle_tracker.h"
+#include "feasibility_validator.h"
+#include "jmt_trajectory_generator.h"
 
 using namespace std;
 
+enum PlannerMode {
+  //score one spline trajectory per reachable lane
+  CANDIDATE_SCORING,
+  //dynamic programming over a lattice of stations and lateral offsets
+  LATTICE,
+  //score perturbed quintic (jerk minimized) trajectories per reachable lane
+  JMT_SAMPLING
+};
+
 class PathPlanner {
 public:
-  PathPlanner();
+  PathPlanner(PlannerMode mode = CANDIDATE_SCORING);
 
   virtual ~PathPlanner();
 
+  /**
+   * Reads mode from its name as given on command line:
+   * candidate_scoring, lattice or jmt_sampling
+   * @returns false if name is none of these
+   */
+  static bool ParseMode(const string &name, PlannerMode &mode);
+
   // Sensor Fusion Data, a list of all other cars on the same side of the road.
   //The data format for each car is: [ id, x, y, vx, vy, s, d]
+  /**
+   * @returns trajectory whose values live in planner's per-cycle workspace,
+   * they are only valid until next GenerateTrajectory() call (of either
+   * overload) resets it. Copy construct it to keep it longer, copies are
+   * on heap (assigning it to an existing trajectory copies too)
+   */
   CartesianTrajectory GenerateTrajectory(const Vehicle &ego_vehicle,
                                 const vector<vector<double> > &sensor_fusion_data,
                                 const vector<double> &previous_path_x,
@@ -32,32 +63,148 @@ public:
                                 const double previous_path_last_s,
                                 const double previous_path_last_d);
 
+  /**
+   * Same as above but previous path points are taken from record of path
+   * we sent, only its size and end points are needed to line that up.
+   * Previous path must be checked with IsEmittedPath() first.
+   * @returns trajectory valid until next call, same as above
+   */
+  CartesianTrajectory GenerateTrajectory(const Vehicle &ego_vehicle,
+                                const vector<vector<double> > &sensor_fusion_data,
+                                const PathEnds &previous_path_ends,
+                                const double previous_path_last_s,
+                                const double previous_path_last_d);
+
+  /**
+   * @returns true if previous path with these ends is what is left of
+   * path we sent, so its points don't have to be read from Simulator
+   */
+  bool IsEmittedPath(const PathEnds &previous_path_ends) const;
+
+  /**
+   * Does work of next cycle that only depends on path we sent, to be
+   * called after a trajectory is sent and before next telemetry arrives.
+   * Next cycle uses results if previous path ends where our path does.
+   */
+  void PrecomputeNextCycle();
+
 private:
-  vector<Vehicle> ExtractSensorFusionData(const vector<vector<double> > &sensor_fusion_data, const int previous_path_size);
+  /**
+   * Plans a trajectory once previous path is set
+   * @param elapsed_time secs since last cycle
+   */
+  CartesianTrajectory PlanCycle(const Vehicle &ego_vehicle,
+                                const vector<vector<double> > &sensor_fusion_data,
+                                const double elapsed_time,
+                                const double previous_path_last_s,
+                                const double previous_path_last_d);
+  void ExtractSensorFusionData(const vector<vector<double> > &sensor_fusion_data, const double elapsed_time,
+                               vector<Vehicle> &vehicles);
   void UpdateEgoVehicleStateWithRespectToPreviousPath();
-  CartesianTrajectory FindBestTrajectory();
+  TrajectoryValues PlanVelocities();
+  /**
+   * @returns planned velocities (from PlanVelocities()) first, then
+   * a profile braking as hard as allowed, for candidates to be scored with
+   */
+  ArenaVector<TrajectoryValues> PlanVelocityVariants();
+  TrajectoryValues PlanBrakingVelocities();
+  CartesianTrajectory FindBestTrajectory(const ArenaVector<TrajectoryValues> &velocity_variants);
+  CartesianTrajectory FindLatticeTrajectory(const TrajectoryValues &velocities);
+  /**
+   * Makes trajectory found in lattice mode the one we go with,
+   * lane_ and path history follow it
+   */
+  CartesianTrajectory SelectLatticeTrajectory(CartesianTrajectory &trajectory);
+  CartesianTrajectory FindJMTTrajectory();
+  /**
+   * Frenet state [x, x_dot, x_dot_dot] of ego vehicle at end of previous
+   * path, from finite differences of its last points when there are enough
+   */
+  void EstimateFrenetState(const FrenetTrajectory &previous_path, Vector3d &state_s, Vector3d &state_d);
+  void ExtractKnownFrenetValues(TrajectoryValues &known_s_values, TrajectoryValues &known_d_values);
+  void UpdatePathHistory(const CartesianTrajectory &trajectory, const FrenetTrajectory &frenet_trajectory);
 
-  double FindDistanceFromVehicleAhead();
-  bool IsTooCloseToVehicleAhead();
-  vector<CartesianTrajectory> GeneratePossibleTrajectories(const vector<int> &valid_lanes);
-  std::__1::vector<int> GetPossibleLanesToGo();
+  ArenaVector<CartesianTrajectory> GeneratePossibleTrajectories(const ArenaVector<int> &valid_lanes,
+                                                                const ArenaVector<TrajectoryValues> &velocity_variants);
+  ArenaVector<int> GetPossibleLanesToGo();
+  /**
+   * @returns false if a vehicle in lane is too close to ego vehicle to move in
+   */
+  bool IsLaneChangeGapViable(int lane);
+  /**
+   * @returns false if JMT goal at time t leaves too little room to slow
+   * down to vehicle ahead of it in lane, or a vehicle is next to it
+   */
+  bool IsJMTGoalGapViable(int lane, double goal_s, double goal_v, double t);
 
   TrajectoryGenerator trajectory_generator_;
   CostFunctions cost_functions_;
+  //per-cycle scratch memory, reset at start of each GenerateTrajectory call.
+  //Members below that outlive a cycle are plain vectors which are
+  //refilled in place so they keep their capacity
+  PlannerWorkspace workspace_;
+  //points we sent to Simulator with their Frenet values, aligned
+  //with previous path at start of each cycle
+  PathHistory path_history_;
+  //looks a few decision points ahead to rank lanes we can go to now
+  BehaviorSearch behavior_search_;
+  LatticePlanner lattice_planner_;
+  JMTTrajectoryGenerator jmt_trajectory_generator_;
+  //plans velocity of new points against vehicles ahead
+  SpeedOptimizer speed_optimizer_;
+  const PlannerMode mode_;
+  //keeps other vehicles across cycles to estimate their acceleration
+  VehicleTracker vehicle_tracker_;
+  //rejects candidates over speed, acceleration or jerk limits
+  FeasibilityValidator feasibility_validator_;
 
   vector<Vehicle> vehicles_;
   Vehicle ego_vehicle_;
   vector<double> previous_path_x_;
   vector<double> previous_path_y_;
+  //last two points of path we sent, previous path of next cycle ends with them
+  vector<double> sent_path_end_x_;
+  vector<double> sent_path_end_y_;
   double previous_path_last_s_;
   double previous_path_last_d_;
 
   int lane_;
+  //velocity (miles/hour) and acceleration (meters/second^2)
+  //ego vehicle will have at end of path sent last cycle
   double reference_velocity_;
+  double reference_acceleration_;
+  //acceleration at end of braking variant, becomes reference one if it is selected
+  double braking_acceleration_;
 
-  const vector<int> possible_lanes_ = {0, 1, 2};
-  const double BUFFER_DISTANCE = 30;
+  const int TRAJECTORY_POINTS_COUNT = 50;
+  //acceleration planned velocities and braking variant stay within, half of
+  //Constants::MAX_ACCELERATION which feasibility validator allows, as spline
+  //curvature and lane changes add lateral acceleration on top of it
+  const double PLANNED_MAX_ACCELERATION = 5; // m/s^2
+  //weight of lookahead regret, compared to cost function weights
+  //(ChangeLaneCost is 10) so that it only wins for a clear gain
+  const double LOOKAHEAD_COST_WEIGHT = 100;
+  //how far ahead JMT goals are, profile of speed optimizer covers 3 secs
+  const double JMT_HORIZON = 2; // s
+  //goal velocities sampled besides one speed optimizer plans
+  const int JMT_GOAL_VELOCITIES_COUNT = 3;
+  //weight of distance of perturbed JMT goal from sampled one, more than
+  //BufferCost (30) so we don't hang back for buffer, less than a collision
+  const double JMT_GOAL_COST_WEIGHT = 50;
+  //weight of velocity a JMT goal gives up compared to max velocity, less
+  //than BufferCost (30) so it doesn't make us tailgate
+  const double JMT_SPEED_COST_WEIGHT = 20;
+  //distance sampled JMT goals keep from vehicle ahead on top of what is needed
+  //to slow down to its speed, same as speed optimizer keeps
+  const double JMT_FOLLOW_DISTANCE = 30; // m
+  //added to cost of braking variant, more than buffer and lane change costs
+  //together but far less than a collision, so we only brake to avoid one
+  const double BRAKING_VARIANT_COST = 100;
   const double SPEED_LIMIT = 49.5;
+  //gap a lane needs around ego vehicle, where new points start and
+  //LANE_CHANGE_DURATION secs later, for a lane change to be considered at all
+  const double MIN_LANE_CHANGE_GAP = 5; // m
+  const double LANE_CHANGE_DURATION = 1; // s
   // The max s value before wrapping around the track back to 0
   const double MAX_S = 6945.554;
 };
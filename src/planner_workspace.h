@@ -0,0 +1,50 @@
+/*
+ * planner_workspace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PLANNER_WORKSPACE_H_
+#define PLANNER_WORKSPACE_H_
+
+#include "arena.h"
+
+/**
+ * Scratch memory for one planning cycle. Everything created through
+ * the workspace (trajectories, candidate lists etc.) lives in its arena
+ * and is released all at once when next cycle begins, so a steady-state
+ * cycle does not touch the heap.
+ */
+class PlannerWorkspace {
+public:
+  PlannerWorkspace() {}
+
+  /**
+   * Must be called at start of each cycle, after that nothing
+   * created in previous cycle is valid anymore.
+   */
+  void BeginCycle() {
+    arena_.Reset();
+  }
+
+  /**
+   * @returns an empty vector backed by workspace arena with
+   * space for at least `capacity` elements
+   */
+  template<class T>
+  ArenaVector<T> MakeVector(size_t capacity = 0) {
+    ArenaVector<T> values((ArenaAllocator<T>(&arena_)));
+    values.reserve(capacity);
+    return values;
+  }
+
+  Arena &arena() {
+    return arena_;
+  }
+
+private:
+  Arena arena_;
+};
+
+#endif /* PLANNER_WORKSPACE_H_ */
@@ -0,0 +1,103 @@
+/*
+ * previous_path_scanner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "previous_path_scanner.h"
+
+PreviousPathScanner::PreviousPathScanner() {
+  this->ends_.size = 0;
+  this->x_begin_ = 0;
+  this->x_end_ = 0;
+  this->y_begin_ = 0;
+  this->y_end_ = 0;
+}
+
+PreviousPathScanner::~PreviousPathScanner() {
+}
+
+bool PreviousPathScanner::Scan(const string &message) {
+  int x_size;
+  int y_size;
+  PathEnds ends;
+  if (!ScanArray(message, "\"previous_path_x\"", x_begin_, x_end_, x_size, ends.first_x, ends.last_x)
+      || !ScanArray(message, "\"previous_path_y\"", y_begin_, y_end_, y_size, ends.first_y, ends.last_y)
+      || x_size != y_size) {
+    return false;
+  }
+
+  ends.size = x_size;
+  ends_ = ends;
+  return true;
+}
+
+const PathEnds &PreviousPathScanner::Ends() const {
+  return ends_;
+}
+
+void PreviousPathScanner::Blank(string &message) const {
+  fill(message.begin() + x_begin_, message.begin() + x_end_, ' ');
+  fill(message.begin() + y_begin_, message.begin() + y_end_, ' ');
+}
+
+bool PreviousPathScanner::ScanArray(const string &message, const char *key, size_t &begin, size_t &end,
+                                    int &size, double &first, double &last) {
+  size_t position = message.find(key);
+  if (position == string::npos) {
+    return false;
+  }
+
+  //skip to opening bracket after key and colon
+  position += strlen(key);
+  while (position < message.size() && (isspace(message[position]) || message[position] == ':')) {
+    ++position;
+  }
+  if (position >= message.size() || message[position] != '[') {
+    return false;
+  }
+  begin = position + 1;
+  end = message.find(']', begin);
+  if (end == string::npos) {
+    return false;
+  }
+
+  //numbers are separated by commas, so those are all we have to count
+  const char *contents = message.data() + begin;
+  const char *contents_end = message.data() + end;
+  const char *last_comma = NULL;
+  int commas_count = 0;
+  bool is_empty = true;
+  for (const char *c = contents; c < contents_end; ++c) {
+    if (*c == ',') {
+      ++commas_count;
+      last_comma = c;
+    } else if (is_empty && !isspace(*c)) {
+      is_empty = false;
+    }
+  }
+  if (is_empty) {
+    size = 0;
+    return true;
+  }
+  size = commas_count + 1;
+
+  //only end points are parsed, strtod stops at comma or bracket
+  char *parsed_end;
+  first = strtod(contents, &parsed_end);
+  if (parsed_end == contents) {
+    return false;
+  }
+  const char *last_value = last_comma != NULL ? last_comma + 1 : contents;
+  last = strtod(last_value, &parsed_end);
+  if (parsed_end == last_value) {
+    return false;
+  }
+
+  return true;
+}
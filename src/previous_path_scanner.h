@@ -0,0 +1,58 @@
+/*
+ * previous_path_scanner.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PREVIOUS_PATH_SCANNER_H_
+#define PREVIOUS_PATH_SCANNER_H_
+
+#include <string>
+#include "path_history.h"
+
+using namespace std;
+
+/**
+ * Finds previous_path_x and previous_path_y arrays in telemetry text and
+ * reads only their size and end points. Previous path is what is left of
+ * path we sent, so when PathPlanner still has it its numbers don't need to
+ * be parsed and arrays can be blanked before the message goes to json parser.
+ */
+class PreviousPathScanner {
+public:
+  PreviousPathScanner();
+  virtual ~PreviousPathScanner();
+
+  /**
+   * @returns false if message does not have both arrays of same size
+   */
+  bool Scan(const string &message);
+
+  /**
+   * @returns ends of previous path found by last successful Scan()
+   */
+  const PathEnds &Ends() const;
+
+  /**
+   * Replaces contents of both arrays with spaces so json parser reads
+   * them as empty. Last Scan() must have succeeded on same message.
+   */
+  void Blank(string &message) const;
+
+private:
+  /**
+   * Finds array of key, its contents are between begin and end (exclusive)
+   * @returns false if there is no such array or its end points can't be read
+   */
+  static bool ScanArray(const string &message, const char *key, size_t &begin, size_t &end,
+                        int &size, double &first, double &last);
+
+  PathEnds ends_;
+  size_t x_begin_;
+  size_t x_end_;
+  size_t y_begin_;
+  size_t y_end_;
+};
+
+#endif /* PREVIOUS_PATH_SCANNER_H_ */
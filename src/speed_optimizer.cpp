@@ -0,0 +1,383 @@
+/*
+ * speed_optimizer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "map_utils.h"
+#include "speed_optimizer.h"
+
+SpeedOptimizer::SpeedOptimizer(double knot_duration)
+    : knot_duration_(knot_duration) {
+  this->start_v_ = 0;
+  this->start_a_ = 0;
+  this->previous_start_s_ = 0;
+  this->has_previous_solution_ = false;
+  this->iterations_ = 0;
+
+  //values are ordered as s_-2, s_-1, s_0 (fixed) and then knots s_1..s_K,
+  //every residual is a finite difference ending at a knot
+  const int FIXED_COUNT = 3;
+  const int VALUES_COUNT = KNOTS_COUNT + FIXED_COUNT;
+  Eigen::Matrix<double, VALUES_COUNT, VALUES_COUNT> hessian = Eigen::Matrix<double, VALUES_COUNT, VALUES_COUNT>::Zero();
+  Eigen::Matrix<double, VALUES_COUNT, 1> velocity_rhs = Eigen::Matrix<double, VALUES_COUNT, 1>::Zero();
+
+  const double dt = knot_duration_;
+  const double velocity_row[] = { 1 / dt, -1 / dt };
+  const double acceleration_row[] = { 1 / (dt * dt), -2 / (dt * dt), 1 / (dt * dt) };
+  const double jerk_row[] = { 1 / (dt * dt * dt), -3 / (dt * dt * dt), 3 / (dt * dt * dt), -1 / (dt * dt * dt) };
+
+  for (int k = 0; k < KNOTS_COUNT; ++k) {
+    const int value = k + FIXED_COUNT;
+
+    //w * (row * s)^2 adds w * row^T * row to hessian
+    for (int i = 0; i < 2; ++i) {
+      for (int j = 0; j < 2; ++j) {
+        hessian(value - i, value - j) += VELOCITY_WEIGHT * velocity_row[i] * velocity_row[j];
+      }
+      //and velocity residual is (row * s - max_v)
+      velocity_rhs(value - i) += VELOCITY_WEIGHT * velocity_row[i];
+    }
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        hessian(value - i, value - j) += ACCELERATION_WEIGHT * acceleration_row[i] * acceleration_row[j];
+      }
+    }
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        hessian(value - i, value - j) += JERK_WEIGHT * jerk_row[i] * jerk_row[j];
+      }
+    }
+  }
+
+  hessian_ = hessian.bottomRightCorner<KNOTS_COUNT, KNOTS_COUNT>();
+  fixed_coupling_ = hessian.bottomLeftCorner<KNOTS_COUNT, FIXED_COUNT>();
+  velocity_rhs_ = velocity_rhs.tail<KNOTS_COUNT>();
+  hessian_inverse_ = hessian_.ldlt().solve(KnotMatrix::Identity());
+
+  //every constraint is a finite difference ending at a knot, same as residuals
+  const double bound_row[] = { 1 };
+  constraints_.setZero();
+  constraint_fixed_coupling_.setZero();
+  for (int k = 0; k < KNOTS_COUNT; ++k) {
+    const int value = k + FIXED_COUNT;
+    limit_scales_[UPPER_BOUND_ROWS + k] = SetConstraint(UPPER_BOUND_ROWS + k, value, bound_row, 1, 1);
+    limit_scales_[LOWER_BOUND_ROWS + k] = SetConstraint(LOWER_BOUND_ROWS + k, value, bound_row, 1, -1);
+    limit_scales_[VELOCITY_ROWS + k] = SetConstraint(VELOCITY_ROWS + k, value, velocity_row, 2, 1);
+    limit_scales_[ACCELERATION_ROWS + k] = SetConstraint(ACCELERATION_ROWS + k, value, acceleration_row, 3, 1);
+    limit_scales_[DECELERATION_ROWS + k] = SetConstraint(DECELERATION_ROWS + k, value, acceleration_row, 3, -1);
+    limit_scales_[JERK_ROWS + k] = SetConstraint(JERK_ROWS + k, value, jerk_row, 4, 1);
+    limit_scales_[NEGATIVE_JERK_ROWS + k] = SetConstraint(NEGATIVE_JERK_ROWS + k, value, jerk_row, 4, -1);
+  }
+  constraint_curvatures_ = (constraints_ * hessian_).cwiseProduct(constraints_).rowwise().sum();
+
+  solution_.setZero();
+  multipliers_.setZero();
+  for (int i = 0; i < CONSTRAINTS_COUNT; ++i) {
+    is_active_[i] = false;
+  }
+}
+
+SpeedOptimizer::~SpeedOptimizer() {
+}
+
+int SpeedOptimizer::Iterations() const {
+  return iterations_;
+}
+
+double SpeedOptimizer::SetConstraint(int constraint, int value, const double *row, int row_length, double sign) {
+  //rows are normalized so that multipliers, and tolerance
+  //they are compared with, mean the same for all constraints
+  double norm = 0;
+  for (int i = 0; i < row_length; ++i) {
+    norm += row[i] * row[i];
+  }
+  norm = sqrt(norm);
+
+  const int FIXED_COUNT = 3;
+  for (int i = 0; i < row_length; ++i) {
+    if (value - i >= FIXED_COUNT) {
+      constraints_(constraint, value - i - FIXED_COUNT) = sign * row[i] / norm;
+    } else {
+      constraint_fixed_coupling_(constraint, value - i) = sign * row[i] / norm;
+    }
+  }
+
+  return 1 / norm;
+}
+
+void SpeedOptimizer::BuildBounds(const vector<Vehicle> &vehicles,
+                                 int lane,
+                                 double start_s,
+                                 double start_t,
+                                 double start_v) {
+  //ego vehicle never goes back
+  lower_.setZero();
+  upper_.setConstant(1e9);
+
+  const double lane_center = MapUtils::GetdValueForLaneCenter(lane);
+  const int vehicles_count = vehicles.size();
+  for (int i = 0; i < vehicles_count; ++i) {
+    const Vehicle &vehicle = vehicles[i];
+    if (fabs(vehicle.d - lane_center) > CUT_IN_DISTANCE || vehicle.s_at(start_t) <= start_s) {
+      continue;
+    }
+
+    for (int k = 0; k < KNOTS_COUNT; ++k) {
+      double t = (k + 1) * knot_duration_;
+
+      //profile ends at horizon but ego vehicle has to be able to slow down
+      //to speed of vehicle ahead after it too, so distance needed for that is
+      //added to follow distance. It depends on velocity we are solving for,
+      //so velocity planned last cycle is used instead
+      double planned_v = has_previous_solution_ ? max(0.0, VelocityAt(t)) : start_v;
+      double closing_v = max(0.0, planned_v - vehicle.v_at(start_t + t));
+      double braking_distance = closing_v * closing_v / (2 * COMFORTABLE_DECELERATION);
+
+      upper_[k] = min(upper_[k], vehicle.s_at(start_t + t) - start_s - FOLLOW_DISTANCE - braking_distance);
+    }
+  }
+
+  //vehicle ahead may already be too close, then best we can do is stop
+  upper_ = upper_.cwiseMax(lower_);
+}
+
+double SpeedOptimizer::MaxJerkAt(int k) const {
+  //s before start are extrapolated with start acceleration only, third
+  //difference over them is a sixth of jerk over first knot (see VelocityAt)
+  return k == 0 ? MAX_JERK / 6 : MAX_JERK;
+}
+
+void SpeedOptimizer::BuildBrakingProfile(const Eigen::Vector3d &fixed_values, double max_a) {
+  //each knot is as low as its deceleration and negative jerk limits and
+  //its lower bound let it be, but never behind knot before it. Only
+  //stopping can break a limit, with a jump of acceleration back to 0
+  const double dt = knot_duration_;
+  double s_3 = fixed_values[0];
+  double s_2 = fixed_values[1];
+  double s_1 = fixed_values[2];
+  for (int k = 0; k < KNOTS_COUNT; ++k) {
+    double s = max(s_1, lower_[k]);
+    s = max(s, 2 * s_1 - s_2 - max_a * dt * dt);
+    s = max(s, 3 * s_1 - 3 * s_2 + s_3 - MaxJerkAt(k) * dt * dt * dt);
+    braking_[k] = s;
+    s_3 = s_2;
+    s_2 = s_1;
+    s_1 = s;
+  }
+}
+
+void SpeedOptimizer::Solve(const KnotVector &rhs) {
+  //unconstrained solution is moved along active rows (A) until they hold, by
+  //multipliers from (A * H^-1 * A^T) * multipliers = A * H^-1 * rhs - limits
+  KnotVector unconstrained = hessian_inverse_ * rhs;
+  multipliers_.setZero();
+
+  int active_count = 0;
+  for (int i = 0; i < CONSTRAINTS_COUNT; ++i) {
+    if (is_active_[i]) {
+      active_constraints_[active_count++] = i;
+    }
+  }
+  if (active_count == 0) {
+    candidate_ = unconstrained;
+    return;
+  }
+
+  active_rows_.resize(active_count, KNOTS_COUNT);
+  active_limits_.resize(active_count);
+  for (int j = 0; j < active_count; ++j) {
+    active_rows_.row(j) = constraints_.row(active_constraints_[j]);
+    active_limits_[j] = limits_[active_constraints_[j]];
+  }
+
+  inverse_times_rows_.noalias() = hessian_inverse_ * active_rows_.transpose();
+  schur_complement_.noalias() = active_rows_ * inverse_times_rows_;
+  schur_ldlt_.compute(schur_complement_);
+  active_limits_ = active_rows_ * unconstrained - active_limits_;
+  active_multipliers_ = schur_ldlt_.solve(active_limits_);
+
+  candidate_ = unconstrained;
+  candidate_.noalias() -= inverse_times_rows_ * active_multipliers_;
+  for (int j = 0; j < active_count; ++j) {
+    multipliers_[active_constraints_[j]] = active_multipliers_[j];
+  }
+}
+
+void SpeedOptimizer::Optimize(const vector<Vehicle> &vehicles,
+                              int lane,
+                              double start_s,
+                              double start_t,
+                              double start_v,
+                              double start_a,
+                              double max_v,
+                              double max_a) {
+  BuildBounds(vehicles, lane, start_s, start_t, start_v);
+
+  //fixed values before start follow from start velocity and acceleration
+  const double dt = knot_duration_;
+  Eigen::Vector3d fixed_values(-2 * start_v * dt + 2 * start_a * dt * dt,
+                               -start_v * dt + start_a * dt * dt / 2,
+                               0);
+  KnotVector rhs = max_v * velocity_rhs_ - fixed_coupling_ * fixed_values;
+
+  for (int k = 0; k < KNOTS_COUNT; ++k) {
+    limits_[UPPER_BOUND_ROWS + k] = upper_[k];
+    limits_[LOWER_BOUND_ROWS + k] = -lower_[k];
+    limits_[VELOCITY_ROWS + k] = max_v;
+    limits_[ACCELERATION_ROWS + k] = max_a;
+    limits_[DECELERATION_ROWS + k] = max_a;
+    limits_[JERK_ROWS + k] = MaxJerkAt(k);
+    limits_[NEGATIVE_JERK_ROWS + k] = MaxJerkAt(k);
+  }
+  limits_ = limits_.cwiseProduct(limit_scales_) - constraint_fixed_coupling_ * fixed_values;
+
+  //vehicle ahead may be closer than we can brake for, or start state may
+  //already be out of limits. Limits braking profile breaks are relaxed to
+  //it, so there is always a feasible profile and braking harder than
+  //acceleration and jerk limits allow is never planned
+  BuildBrakingProfile(fixed_values, max_a);
+  limits_ = limits_.cwiseMax(constraints_ * braking_);
+
+  //warm start: last solution moved to where this profile starts,
+  //knots ego vehicle has moved past since last cycle are dropped and
+  //ones past its end continue with its last velocity. It is clamped to
+  //bounds and knots that end up on a bound they were held at stay held
+  double moved = start_s - previous_start_s_;
+  int shift = 0;
+  double last_value = solution_[KNOTS_COUNT - 1];
+  double last_step = solution_[KNOTS_COUNT - 1] - solution_[KNOTS_COUNT - 2];
+  if (has_previous_solution_ && moved >= 0) {
+    while (shift < KNOTS_COUNT && solution_[shift] <= moved) {
+      ++shift;
+    }
+  } else {
+    //nothing to start from, profile keeps start velocity
+    shift = KNOTS_COUNT;
+    moved = 0;
+    last_value = 0;
+    last_step = start_v * dt;
+  }
+  for (int k = 0; k < KNOTS_COUNT; ++k) {
+    const int previous_k = k + shift;
+    const bool has_previous_k = previous_k < KNOTS_COUNT;
+    double previous_value = has_previous_k ? solution_[previous_k]
+        : last_value + (previous_k - KNOTS_COUNT + 1) * last_step;
+    bool was_at_upper = has_previous_k && is_active_[UPPER_BOUND_ROWS + previous_k];
+    bool was_at_lower = has_previous_k && is_active_[LOWER_BOUND_ROWS + previous_k];
+    double upper = limits_[UPPER_BOUND_ROWS + k];
+    double value = max(lower_[k], min(upper, previous_value - moved));
+
+    is_active_[UPPER_BOUND_ROWS + k] = was_at_upper && value == upper;
+    is_active_[LOWER_BOUND_ROWS + k] = was_at_lower && value == lower_[k] && !is_active_[UPPER_BOUND_ROWS + k];
+    solution_[k] = value;
+  }
+  //other constraints are found again by solves, that
+  //keeps active ones linearly independent
+  for (int i = VELOCITY_ROWS; i < CONSTRAINTS_COUNT; ++i) {
+    is_active_[i] = false;
+  }
+
+  //warm start must be feasible, when it breaks a limit
+  //(start state changed, vehicle cut in) we start from braking profile
+  if (((constraints_ * solution_).array() > (limits_.array() + TOLERANCE)).any()) {
+    solution_ = braking_;
+    for (int i = 0; i < CONSTRAINTS_COUNT; ++i) {
+      is_active_[i] = false;
+    }
+  }
+
+  //primal active set method, solution_ stays feasible all the time
+  //so if we run out of iterations it is still a usable profile
+  for (iterations_ = 1; iterations_ <= MAX_ITERATIONS; ++iterations_) {
+    Solve(rhs);
+
+    //move towards solution with current active set as far as constraints
+    //allow, first constraint in the way is added to active set
+    KnotVector direction = candidate_ - solution_;
+    double step = 1;
+    int blocking_constraint = -1;
+    for (int i = 0; i < CONSTRAINTS_COUNT; ++i) {
+      if (is_active_[i]) {
+        continue;
+      }
+      //profile following a bound exactly is common (keeping distance from
+      //vehicle ahead), tolerance keeps rounding errors from blocking it.
+      //Profile can be that little out of bounds, so step is never negative
+      double change = constraints_.row(i).dot(direction);
+      if (change > 0 && constraints_.row(i).dot(candidate_) > limits_[i] + TOLERANCE) {
+        double constraint_step = max(0.0, (limits_[i] - constraints_.row(i).dot(solution_)) / change);
+        if (constraint_step < step) {
+          step = constraint_step;
+          blocking_constraint = i;
+        }
+      }
+    }
+
+    solution_ += step * direction;
+    if (blocking_constraint != -1) {
+      is_active_[blocking_constraint] = true;
+      continue;
+    }
+
+    //release a constraint which is holding profile back from a better one.
+    //Negative multiplier over curvature of its row is how far profile would
+    //move away from it, constraints holding it back less than tolerance
+    //are not worth another solve
+    int released_constraint = -1;
+    double max_movement = TOLERANCE;
+    for (int i = 0; i < CONSTRAINTS_COUNT; ++i) {
+      if (!is_active_[i]) {
+        continue;
+      }
+      const int k = i % KNOTS_COUNT;
+      if (i < VELOCITY_ROWS && limits_[UPPER_BOUND_ROWS + k] <= -limits_[LOWER_BOUND_ROWS + k]) {
+        //knot has nowhere to go, releasing it would only flip it between its bounds
+        continue;
+      }
+      double movement = -multipliers_[i] / constraint_curvatures_[i];
+      if (movement > max_movement) {
+        max_movement = movement;
+        released_constraint = i;
+      }
+    }
+    if (released_constraint == -1) {
+      break;
+    }
+    is_active_[released_constraint] = false;
+  }
+  iterations_ = min(iterations_, MAX_ITERATIONS);
+
+  start_v_ = start_v;
+  start_a_ = start_a;
+  previous_start_s_ = start_s;
+  has_previous_solution_ = true;
+}
+
+double SpeedOptimizer::VelocityAt(double t) const {
+  //up to middle of first knot velocity follows start acceleration and jerk
+  //of first knot, each cycle sends only first few points so that keeps
+  //acceleration continuous between cycles. After that velocity between two
+  //knots belongs to middle of them, in between it is interpolated linearly
+  const double dt = knot_duration_;
+  double start_jerk = 6 * (solution_[0] - start_v_ * dt - start_a_ * dt * dt / 2) / (dt * dt * dt);
+  double previous_t = min(t, dt / 2);
+  double previous_v = start_v_ + start_a_ * previous_t + start_jerk * previous_t * previous_t / 2;
+  if (t <= dt / 2) {
+    return previous_v;
+  }
+  for (int k = 1; k < KNOTS_COUNT; ++k) {
+    double knot_t = (k + 0.5) * dt;
+    double knot_v = (solution_[k] - solution_[k - 1]) / dt;
+    if (t <= knot_t) {
+      return previous_v + (knot_v - previous_v) * (t - previous_t) / (knot_t - previous_t);
+    }
+    previous_t = knot_t;
+    previous_v = knot_v;
+  }
+
+  return previous_v;
+}
@@ -0,0 +1,170 @@
+/*
+ * speed_optimizer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SPEED_OPTIMIZER_H_
+#define SPEED_OPTIMIZER_H_
+
+#include <vector>
+#include "Eigen/Dense"
+#include "vehicle.h"
+
+using namespace std;
+
+/**
+ * Plans longitudinal (speed) profile of ego vehicle on an s-t graph.
+ *
+ * Unknowns are s values at knots `knot_duration` seconds apart, relative to
+ * where path starts. Cost is weighted sum of squared jerk, acceleration and
+ * difference from max velocity (finite differences of s), vehicles ahead in
+ * ego lane or cutting into it put an upper bound on s at each knot. Velocity,
+ * acceleration and jerk at each knot are kept within limits by linear
+ * inequality constraints on the same finite differences. That is a small QP,
+ * solved with an active set method. Hessian does not change so it is built
+ * (and inverted) once, and active bounds of last cycle are the first guess of
+ * this cycle so usually a few solves are enough.
+ */
+class SpeedOptimizer {
+public:
+  static const int KNOTS_COUNT = 15;
+  //upper and lower bound of s, max velocity, max acceleration both ways
+  //and max jerk both ways at each knot
+  static const int CONSTRAINTS_COUNT = 7 * KNOTS_COUNT;
+
+  SpeedOptimizer(double knot_duration = 0.2);
+  virtual ~SpeedOptimizer();
+
+  /**
+   * @param start_s  s where profile starts (end of previous path)
+   * @param start_t  time from now in seconds at which ego vehicle will be at start_s
+   * @param start_v, start_a  ego vehicle state at start_s in meters/second(^2)
+   * @param max_v  velocity to keep when nothing is ahead and not to exceed, in meters/second
+   * @param max_a  acceleration (both ways) not to exceed, in meters/second^2
+   */
+  void Optimize(const vector<Vehicle> &vehicles,
+                int lane,
+                double start_s,
+                double start_t,
+                double start_v,
+                double start_a,
+                double max_v,
+                double max_a);
+
+  /**
+   * @returns planned velocity in meters/second t seconds after profile start
+   */
+  double VelocityAt(double t) const;
+
+  /**
+   * @returns number of QP solves last Optimize call needed
+   */
+  int Iterations() const;
+
+private:
+  typedef Eigen::Matrix<double, KNOTS_COUNT, KNOTS_COUNT> KnotMatrix;
+  typedef Eigen::Matrix<double, KNOTS_COUNT, 1> KnotVector;
+  typedef Eigen::Matrix<double, CONSTRAINTS_COUNT, KNOTS_COUNT> ConstraintMatrix;
+  typedef Eigen::Matrix<double, CONSTRAINTS_COUNT, 1> ConstraintVector;
+  //active constraints are linearly independent so there are at most as
+  //many as knots, max sizes keep these off the heap
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, KNOTS_COUNT, KNOTS_COUNT> ActiveMatrix;
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1, 0, KNOTS_COUNT, 1> ActiveVector;
+
+  //first row of each group of constraints, group has a row per knot
+  static const int UPPER_BOUND_ROWS = 0;
+  static const int LOWER_BOUND_ROWS = KNOTS_COUNT;
+  static const int VELOCITY_ROWS = 2 * KNOTS_COUNT;
+  static const int ACCELERATION_ROWS = 3 * KNOTS_COUNT;
+  static const int DECELERATION_ROWS = 4 * KNOTS_COUNT;
+  static const int JERK_ROWS = 5 * KNOTS_COUNT;
+  static const int NEGATIVE_JERK_ROWS = 6 * KNOTS_COUNT;
+
+  void BuildBounds(const vector<Vehicle> &vehicles, int lane, double start_s, double start_t, double start_v);
+
+  /**
+   * @returns limit of third difference of s ending at knot k, over knot_duration^3
+   */
+  double MaxJerkAt(int k) const;
+
+  /**
+   * Sets braking_ to profile braking as hard as limits allow from start
+   * state, `fixed_values` are s before start that follow from it
+   */
+  void BuildBrakingProfile(const Eigen::Vector3d &fixed_values, double max_a);
+
+  /**
+   * Sets constraint row from a finite difference `row` ending at value
+   * (in order of values, fixed ones first), normalized to unit length
+   * @returns what a limit of the finite difference is scaled by
+   */
+  double SetConstraint(int constraint, int value, const double *row, int row_length, double sign);
+
+  /**
+   * Solves QP with constraints in active set held as equalities,
+   * sets candidate_ and multipliers_ of active constraints
+   */
+  void Solve(const KnotVector &rhs);
+
+  const double knot_duration_;
+
+  //hessian of knot values and its coupling to 3 fixed values
+  //(s at -2*knot_duration, -knot_duration and 0 which come from start state)
+  KnotMatrix hessian_;
+  Eigen::Matrix<double, KNOTS_COUNT, 3> fixed_coupling_;
+  //linear term per meter/second of max velocity
+  KnotVector velocity_rhs_;
+
+  KnotMatrix hessian_inverse_;
+
+  //rows of constraints (constraints_ * s <= limits_) over knot values,
+  //their coupling to fixed values and their curvature (row * hessian * row)
+  ConstraintMatrix constraints_;
+  Eigen::Matrix<double, CONSTRAINTS_COUNT, 3> constraint_fixed_coupling_;
+  ConstraintVector constraint_curvatures_;
+  //what limit of velocity, acceleration or jerk is scaled by in normalized row
+  ConstraintVector limit_scales_;
+
+  KnotVector lower_;
+  KnotVector upper_;
+  ConstraintVector limits_;
+  KnotVector braking_;
+  KnotVector solution_;
+  //solution of QP with current active set, may violate inactive constraints
+  KnotVector candidate_;
+  ConstraintVector multipliers_;
+  bool is_active_[CONSTRAINTS_COUNT];
+
+  //scratch of Solve()
+  int active_constraints_[KNOTS_COUNT];
+  ActiveMatrix active_rows_;
+  ActiveVector active_limits_;
+  Eigen::Matrix<double, KNOTS_COUNT, Eigen::Dynamic, 0, KNOTS_COUNT, KNOTS_COUNT> inverse_times_rows_;
+  ActiveMatrix schur_complement_;
+  Eigen::LDLT<ActiveMatrix> schur_ldlt_;
+  ActiveVector active_multipliers_;
+
+  double start_v_;
+  double start_a_;
+  double previous_start_s_;
+  bool has_previous_solution_;
+  int iterations_;
+
+  const double JERK_WEIGHT = 1;
+  const double ACCELERATION_WEIGHT = 9;
+  const double VELOCITY_WEIGHT = 1;
+  //jerk between knots, velocity interpolated between them adds some
+  //on top so it is half of what feasibility validator allows
+  const double MAX_JERK = 5; // m/s^3
+  //distance to keep from vehicle ahead
+  const double FOLLOW_DISTANCE = 30;
+  const double COMFORTABLE_DECELERATION = 3; // m/s^2
+  //vehicles this close (in d) to center of ego lane overlap it
+  const double CUT_IN_DISTANCE = 3;
+  const int MAX_ITERATIONS = 30;
+  const double TOLERANCE = 1e-4;
+};
+
+#endif /* SPEED_OPTIMIZER_H_ */
@@ -45,33 +45,39 @@ namespace tk
 class band_matrix
 {
 private:
-    std::vector< std::vector<double> > m_upper;  // upper band
-    std::vector< std::vector<double> > m_lower;  // lower band
+    // all bands stored in one flat array, one row of length dim per band:
+    // rows 0..n_u hold the diagonal and upper bands and rows
+    // n_u+1..n_u+n_l hold the lower bands
+    std::vector<double> m_bands;
+    int m_dim, m_num_upper, m_num_lower;
+    double * band(int k)
+    {
+        return &m_bands[(k>=0 ? k : m_num_upper-k)*m_dim];
+    }
+    const double * band(int k) const
+    {
+        return &m_bands[(k>=0 ? k : m_num_upper-k)*m_dim];
+    }
 public:
-    band_matrix() {};                             // constructor
-    band_matrix(int dim, int n_u, int n_l);       // constructor
+    band_matrix(): m_dim(0), m_num_upper(0), m_num_lower(0) {};  // constructor
     ~band_matrix() {};                            // destructor
     void resize(int dim, int n_u, int n_l);      // init with dim,n_u,n_l
     int dim() const;                             // matrix dimension
     int num_upper() const
     {
-        return m_upper.size()-1;
+        return m_num_upper;
     }
     int num_lower() const
     {
-        return m_lower.size()-1;
+        return m_num_lower;
     }
     // access operator
     double & operator () (int i, int j);            // write
-    double   operator () (int i, int j) const;      // read
-    // we can store an additional diogonal (in m_lower)
-    double& saved_diag(int i);
-    double  saved_diag(int i) const;
-    void lu_decompose();
-    std::vector<double> r_solve(const std::vector<double>& b) const;
-    std::vector<double> l_solve(const std::vector<double>& b) const;
-    std::vector<double> lu_solve(const std::vector<double>& b,
-                                 bool is_lu_decomposed=false);
+    // Thomas algorithm for tridiagonal matrices (n_u=n_l=1), solves
+    // in place: b is overwritten by the solution x and the diagonal
+    // of the matrix is destroyed, no pivoting so the matrix has to be
+    // diagonally dominant (which holds for cubic spline systems)
+    void tridiagonal_solve(std::vector<double>& b);
 
 };
 
@@ -94,6 +100,7 @@ private:
     bd_type m_left, m_right;
     double  m_left_value, m_right_value;
     bool    m_force_linear_extrapolation;
+    band_matrix m_band;                     // reused by set_points() calls
 
 public:
     // set default boundary condition to be zero curvature at both ends
@@ -124,31 +131,19 @@ public:
 // band_matrix implementation
 // -------------------------
 
-band_matrix::band_matrix(int dim, int n_u, int n_l)
-{
-    resize(dim, n_u, n_l);
-}
 void band_matrix::resize(int dim, int n_u, int n_l)
 {
     assert(dim>0);
     assert(n_u>=0);
     assert(n_l>=0);
-    m_upper.resize(n_u+1);
-    m_lower.resize(n_l+1);
-    for(size_t i=0; i<m_upper.size(); i++) {
-        m_upper[i].resize(dim);
-    }
-    for(size_t i=0; i<m_lower.size(); i++) {
-        m_lower[i].resize(dim);
-    }
+    m_dim=dim;
+    m_num_upper=n_u;
+    m_num_lower=n_l;
+    m_bands.assign((n_u+n_l+1)*dim, 0.0);
 }
 int band_matrix::dim() const
 {
-    if(m_upper.size()>0) {
-        return m_upper[0].size();
-    } else {
-        return 0;
-    }
+    return m_dim;
 }
 
 
@@ -160,107 +155,30 @@ double & band_matrix::operator () (int i, int j)
     assert( (i>=0) && (i<dim()) && (j>=0) && (j<dim()) );
     assert( (-num_lower()<=k) && (k<=num_upper()) );
     // k=0 -> diogonal, k<0 lower left part, k>0 upper right part
-    if(k>=0)   return m_upper[k][i];
-    else	    return m_lower[-k][i];
-}
-double band_matrix::operator () (int i, int j) const
-{
-    int k=j-i;       // what band is the entry
-    assert( (i>=0) && (i<dim()) && (j>=0) && (j<dim()) );
-    assert( (-num_lower()<=k) && (k<=num_upper()) );
-    // k=0 -> diogonal, k<0 lower left part, k>0 upper right part
-    if(k>=0)   return m_upper[k][i];
-    else	    return m_lower[-k][i];
-}
-// second diag (used in LU decomposition), saved in m_lower
-double band_matrix::saved_diag(int i) const
-{
-    assert( (i>=0) && (i<dim()) );
-    return m_lower[0][i];
+    return band(k)[i];
 }
-double & band_matrix::saved_diag(int i)
-{
-    assert( (i>=0) && (i<dim()) );
-    return m_lower[0][i];
-}
-
-// LR-Decomposition of a band matrix
-void band_matrix::lu_decompose()
-{
-    int  i_max,j_max;
-    int  j_min;
-    double x;
-
-    // preconditioning
-    // normalize column i so that a_ii=1
-    for(int i=0; i<this->dim(); i++) {
-        assert(this->operator()(i,i)!=0.0);
-        this->saved_diag(i)=1.0/this->operator()(i,i);
-        j_min=std::max(0,i-this->num_lower());
-        j_max=std::min(this->dim()-1,i+this->num_upper());
-        for(int j=j_min; j<=j_max; j++) {
-            this->operator()(i,j) *= this->saved_diag(i);
-        }
-        this->operator()(i,i)=1.0;          // prevents rounding errors
-    }
-
-    // Gauss LR-Decomposition
-    for(int k=0; k<this->dim(); k++) {
-        i_max=std::min(this->dim()-1,k+this->num_lower());  // num_lower not a mistake!
-        for(int i=k+1; i<=i_max; i++) {
-            assert(this->operator()(k,k)!=0.0);
-            x=-this->operator()(i,k)/this->operator()(k,k);
-            this->operator()(i,k)=-x;                         // assembly part of L
-            j_max=std::min(this->dim()-1,k+this->num_upper());
-            for(int j=k+1; j<=j_max; j++) {
-                // assembly part of R
-                this->operator()(i,j)=this->operator()(i,j)+x*this->operator()(k,j);
-            }
-        }
-    }
-}
-// solves Ly=b
-std::vector<double> band_matrix::l_solve(const std::vector<double>& b) const
-{
-    assert( this->dim()==(int)b.size() );
-    std::vector<double> x(this->dim());
-    int j_start;
-    double sum;
-    for(int i=0; i<this->dim(); i++) {
-        sum=0;
-        j_start=std::max(0,i-this->num_lower());
-        for(int j=j_start; j<i; j++) sum += this->operator()(i,j)*x[j];
-        x[i]=(b[i]*this->saved_diag(i)) - sum;
-    }
-    return x;
-}
-// solves Rx=y
-std::vector<double> band_matrix::r_solve(const std::vector<double>& b) const
+// solves Ax=b in place for tridiagonal A
+void band_matrix::tridiagonal_solve(std::vector<double>& b)
 {
+    assert( m_num_upper==1 && m_num_lower==1 );
     assert( this->dim()==(int)b.size() );
-    std::vector<double> x(this->dim());
-    int j_stop;
-    double sum;
-    for(int i=this->dim()-1; i>=0; i--) {
-        sum=0;
-        j_stop=std::min(this->dim()-1,i+this->num_upper());
-        for(int j=i+1; j<=j_stop; j++) sum += this->operator()(i,j)*x[j];
-        x[i]=( b[i] - sum ) / this->operator()(i,i);
+    const int n=m_dim;
+    double* diag=band(0);
+    const double* upper=band(1);
+    const double* lower=band(-1);
+    // forward elimination, lower[i] is A(i,i-1) and upper[i] is A(i,i+1)
+    for(int i=1; i<n; i++) {
+        assert(diag[i-1]!=0.0);
+        double w=lower[i]/diag[i-1];
+        diag[i] -= w*upper[i-1];
+        b[i] -= w*b[i-1];
     }
-    return x;
-}
-
-std::vector<double> band_matrix::lu_solve(const std::vector<double>& b,
-        bool is_lu_decomposed)
-{
-    assert( this->dim()==(int)b.size() );
-    std::vector<double>  x,y;
-    if(is_lu_decomposed==false) {
-        this->lu_decompose();
+    // back substitution
+    assert(diag[n-1]!=0.0);
+    b[n-1] /= diag[n-1];
+    for(int i=n-2; i>=0; i--) {
+        b[i]=(b[i]-upper[i]*b[i+1])/diag[i];
     }
-    y=this->l_solve(b);
-    x=this->r_solve(y);
-    return x;
 }
 
 
@@ -298,8 +216,12 @@ void spline::set_points(const std::vector<double>& x,
     if(cubic_spline==true) { // cubic spline interpolation
         // setting up the matrix and right hand side of the equation system
         // for the parameters b[]
-        band_matrix A(n,1,1);
-        std::vector<double>  rhs(n);
+        // the system is tridiagonal, the right hand side is assembled
+        // directly in m_b which then gets overwritten by the solution
+        band_matrix& A=m_band;
+        A.resize(n,1,1);
+        std::vector<double>& rhs=m_b;
+        rhs.assign(n, 0.0);
         for(int i=1; i<n-1; i++) {
             A(i,i-1)=1.0/3.0*(x[i]-x[i-1]);
             A(i,i)=2.0/3.0*(x[i+1]-x[i-1]);
@@ -338,7 +260,7 @@ void spline::set_points(const std::vector<double>& x,
         }
 
         // solve the equation system to obtain the parameters b[]
-        m_b=A.lu_solve(rhs);
+        A.tridiagonal_solve(m_b);
 
         // calculate parameters a[] and c[] based on b[]
         m_a.resize(n);
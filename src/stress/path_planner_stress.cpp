@@ -0,0 +1,229 @@
+/*
+ * path_planner_stress.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../map_utils.h"
+#include "../path_planner.h"
+#include "scenario_generator.h"
+#include "work_stealing_pool.h"
+
+using namespace std;
+
+/**
+ * Runs PathPlanner closed loop on thousands of synthetic traffic scenarios
+ * in parallel and reports latency of GenerateTrajectory and decisions it
+ * made per scenario type and vehicle count. This is a benchmark, not a test,
+ * nothing fails when numbers get worse.
+ *
+ * Usage: path_planner_stress [scenarios] [threads] [cycles] [map file] [planner mode]
+ */
+
+namespace {
+
+const int VEHICLE_COUNTS[] = { 4, 8, 16, 32, 64 };
+const int VEHICLE_COUNTS_SIZE = sizeof(VEHICLE_COUNTS) / sizeof(VEHICLE_COUNTS[0]);
+//Simulator drives through this many points between two planning cycles
+const int CONSUMED_POINTS_COUNT = 3;
+const double MPH_PER_METERS_PER_SECOND = 3600 / 1609.34;
+
+struct ScenarioResult {
+  ScenarioType type;
+  int vehicles_count;
+  //microseconds of each GenerateTrajectory call
+  vector<double> latencies;
+  int lane_changes;
+  //cycles in which ego vehicle overlapped another vehicle
+  int collision_cycles;
+  double final_speed;
+};
+
+ScenarioResult RunScenario(const ScenarioGenerator &generator, int scenario_index, int cycles, PlannerMode mode) {
+  //scenario only depends on its index, not on which thread runs it
+  mt19937 random(scenario_index);
+  ScenarioType type = ScenarioType(scenario_index % SCENARIO_TYPES_COUNT);
+  int vehicles_count = VEHICLE_COUNTS[(scenario_index / SCENARIO_TYPES_COUNT) % VEHICLE_COUNTS_SIZE];
+  Scenario scenario = generator.Generate(type, vehicles_count, random);
+
+  ScenarioResult result;
+  result.type = type;
+  result.vehicles_count = vehicles_count;
+  result.latencies.reserve(cycles);
+  result.lane_changes = 0;
+  result.collision_cycles = 0;
+  result.final_speed = 0;
+
+  PathPlanner path_planner(mode);
+  double car_x;
+  double car_y;
+  MapUtils::getXY(scenario.ego_s, scenario.ego_d, car_x, car_y);
+  double car_s = scenario.ego_s;
+  double car_d = scenario.ego_d;
+  double car_yaw = MapUtils::GetHeading(car_s);
+  double car_speed = 0;
+  vector<double> previous_path_x;
+  vector<double> previous_path_y;
+  double end_s = 0;
+  double end_d = 0;
+  int lane = MapUtils::GetLane(car_d);
+
+  vector<vector<double> > sensor_fusion;
+  for (int cycle = 0; cycle < cycles; ++cycle) {
+    //sensor fusion in Simulator's format [ id, x, y, vx, vy, s, d]
+    sensor_fusion.resize(scenario.vehicles.size());
+    for (int i = 0; i < scenario.vehicles.size(); ++i) {
+      const SimulatedVehicle &vehicle = scenario.vehicles[i];
+      double x;
+      double y;
+      MapUtils::getXY(vehicle.s, vehicle.d, x, y);
+      double heading = MapUtils::GetHeading(vehicle.s);
+      sensor_fusion[i] = { double(i), x, y, vehicle.v * cos(heading), vehicle.v * sin(heading), vehicle.s, vehicle.d };
+    }
+
+    Vehicle ego_vehicle(-1, car_x, car_y, car_s, car_d, car_yaw, car_speed * MPH_PER_METERS_PER_SECOND, 0);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    CartesianTrajectory trajectory = path_planner.GenerateTrajectory(ego_vehicle, sensor_fusion, previous_path_x,
+                                                                     previous_path_y, end_s, end_d);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    result.latencies.push_back(chrono::duration<double, micro>(end - start).count());
+
+    if (trajectory.lane != lane) {
+      ++result.lane_changes;
+      lane = trajectory.lane;
+    }
+
+    //drive through first points of trajectory like Simulator does
+    const int points_count = trajectory.x_values.size();
+    if (points_count <= CONSUMED_POINTS_COUNT + 1) {
+      break;
+    }
+    double last_x = trajectory.x_values[CONSUMED_POINTS_COUNT - 2];
+    double last_y = trajectory.y_values[CONSUMED_POINTS_COUNT - 2];
+    car_x = trajectory.x_values[CONSUMED_POINTS_COUNT - 1];
+    car_y = trajectory.y_values[CONSUMED_POINTS_COUNT - 1];
+    car_yaw = atan2(car_y - last_y, car_x - last_x);
+    car_speed = sqrt((car_x - last_x) * (car_x - last_x) + (car_y - last_y) * (car_y - last_y)) / 0.02;
+    MapUtils::getFrenet(car_x, car_y, car_yaw, car_s, car_d);
+
+    previous_path_x.assign(trajectory.x_values.begin() + CONSUMED_POINTS_COUNT, trajectory.x_values.end());
+    previous_path_y.assign(trajectory.y_values.begin() + CONSUMED_POINTS_COUNT, trajectory.y_values.end());
+    const int previous_size = previous_path_x.size();
+    double end_yaw = atan2(previous_path_y[previous_size - 1] - previous_path_y[previous_size - 2],
+                           previous_path_x[previous_size - 1] - previous_path_x[previous_size - 2]);
+    MapUtils::getFrenet(previous_path_x[previous_size - 1], previous_path_y[previous_size - 1], end_yaw, end_s, end_d);
+
+    ScenarioGenerator::Step(cycle * CONSUMED_POINTS_COUNT * 0.02, CONSUMED_POINTS_COUNT * 0.02, scenario);
+
+    for (int i = 0; i < scenario.vehicles.size(); ++i) {
+      const SimulatedVehicle &vehicle = scenario.vehicles[i];
+      if (fabs(vehicle.d - car_d) < 2 && fabs(vehicle.s - car_s) < 4.5) {
+        ++result.collision_cycles;
+        break;
+      }
+    }
+  }
+  result.final_speed = car_speed;
+
+  return result;
+}
+
+double Percentile(vector<double> &values, double percentile) {
+  if (values.empty()) {
+    return 0;
+  }
+  int index = min((int) values.size() - 1, int(percentile / 100 * values.size()));
+  nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+}
+
+int main(int argc, char **argv) {
+  int scenarios_count = argc > 1 ? atoi(argv[1]) : 1000;
+  int threads_count = argc > 2 ? atoi(argv[2]) : max(1, (int) thread::hardware_concurrency());
+  int cycles = argc > 3 ? atoi(argv[3]) : 500;
+  const char *map_file = argc > 4 ? argv[4] : "data/highway_map.csv";
+  const char *mode_name = argc > 5 ? argv[5] : "candidate_scoring";
+  PlannerMode mode;
+  if (!PathPlanner::ParseMode(mode_name, mode)) {
+    fprintf(stderr, "Unknown planner mode %s, use candidate_scoring, lattice or jmt_sampling\n", mode_name);
+    return 1;
+  }
+
+  //planner logs every cycle, keep report readable by sending that to /dev/null
+  FILE *report = fdopen(dup(fileno(stdout)), "w");
+  if (freopen("/dev/null", "w", stdout) == NULL || freopen("/dev/null", "w", stderr) == NULL) {
+    fprintf(report, "Unable to silence planner output\n");
+  }
+  MapUtils::Initialize(map_file);
+
+  ScenarioGenerator generator;
+  vector<ScenarioResult> results(scenarios_count);
+  WorkStealingPool pool(threads_count);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  pool.Run(scenarios_count, [&](int worker, int scenario_index) {
+    results[scenario_index] = RunScenario(generator, scenario_index, cycles, mode);
+  });
+  double wall_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  long calls_count = 0;
+  for (int i = 0; i < scenarios_count; ++i) {
+    calls_count += results[i].latencies.size();
+  }
+  fprintf(report, "%d scenarios, %d cycles each, %s mode, %d threads (%d tasks stolen)\n", scenarios_count, cycles,
+          mode_name, pool.ThreadsCount(), pool.StolenCount());
+  fprintf(report, "wall time %.2f s, %.0f planning cycles/s\n\n", wall_seconds, calls_count / wall_seconds);
+
+  fprintf(report, "%-14s %8s %9s %9s %9s %9s %12s %12s %10s\n", "type", "vehicles", "scenarios", "mean_us",
+          "p50_us", "p99_us", "lane_changes", "collisions", "final_mph");
+  for (int type = 0; type < SCENARIO_TYPES_COUNT; ++type) {
+    for (int c = 0; c < VEHICLE_COUNTS_SIZE; ++c) {
+      vector<double> latencies;
+      int count = 0;
+      double lane_changes = 0;
+      int collision_scenarios = 0;
+      double final_speed = 0;
+      for (int i = 0; i < scenarios_count; ++i) {
+        const ScenarioResult &result = results[i];
+        if (result.type != type || result.vehicles_count != VEHICLE_COUNTS[c]) {
+          continue;
+        }
+        ++count;
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        lane_changes += result.lane_changes;
+        collision_scenarios += result.collision_cycles > 0 ? 1 : 0;
+        final_speed += result.final_speed * MPH_PER_METERS_PER_SECOND;
+      }
+      if (count == 0) {
+        continue;
+      }
+
+      double mean = 0;
+      for (int i = 0; i < latencies.size(); ++i) {
+        mean += latencies[i];
+      }
+      mean /= max(1, (int) latencies.size());
+      double p50 = Percentile(latencies, 50);
+      double p99 = Percentile(latencies, 99);
+
+      fprintf(report, "%-14s %8d %9d %9.1f %9.1f %9.1f %12.2f %12d %10.1f\n",
+              ScenarioGenerator::TypeName(ScenarioType(type)).c_str(), VEHICLE_COUNTS[c], count, mean, p50, p99,
+              lane_changes / count, collision_scenarios, final_speed / count);
+    }
+  }
+  fclose(report);
+
+  return 0;
+}
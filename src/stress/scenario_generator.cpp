@@ -0,0 +1,154 @@
+/*
+ * scenario_generator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "../map_utils.h"
+#include "scenario_generator.h"
+
+ScenarioGenerator::ScenarioGenerator() {
+}
+
+ScenarioGenerator::~ScenarioGenerator() {
+}
+
+string ScenarioGenerator::TypeName(ScenarioType type) {
+  switch (type) {
+    case FREE_ROAD:
+      return "free_road";
+    case DENSE_PLATOON:
+      return "dense_platoon";
+    case CUT_IN:
+      return "cut_in";
+    case STALLED_CAR:
+      return "stalled_car";
+    default:
+      return "unknown";
+  }
+}
+
+bool ScenarioGenerator::IsFree(const Scenario &scenario, int lane, double s, double gap) const {
+  double d = MapUtils::GetdValueForLaneCenter(lane);
+  if (fabs(d - scenario.ego_d) < 2 && fabs(s - scenario.ego_s) < gap) {
+    return false;
+  }
+
+  for (int i = 0; i < scenario.vehicles.size(); ++i) {
+    const SimulatedVehicle &vehicle = scenario.vehicles[i];
+    if (fabs(vehicle.d - d) < 2 && fabs(vehicle.s - s) < gap) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ScenarioGenerator::AddBackgroundTraffic(Scenario &scenario, int vehicles_count, mt19937 &random) const {
+  uniform_int_distribution<int> lane_distribution(0, MapUtils::LanesCount() - 1);
+  //only ahead of ego vehicle, simulated traffic does not react to ego
+  //vehicle so anything behind would just run into it while it speeds up
+  uniform_real_distribution<double> s_distribution(MIN_GAP, 400);
+  normal_distribution<double> speed_distribution(MEAN_SPEED, SPEED_DEVIATION);
+
+  //give up on a vehicle if there is no room for it after a few tries
+  const int max_tries = 20;
+  for (int i = 0; i < vehicles_count; ++i) {
+    for (int attempt = 0; attempt < max_tries; ++attempt) {
+      int lane = lane_distribution(random);
+      double s = scenario.ego_s + s_distribution(random);
+      if (!IsFree(scenario, lane, s, MIN_GAP)) {
+        continue;
+      }
+
+      double d = MapUtils::GetdValueForLaneCenter(lane);
+      SimulatedVehicle vehicle = { s, d, max(0.0, speed_distribution(random)), d, 0, 0 };
+      scenario.vehicles.push_back(vehicle);
+      break;
+    }
+  }
+}
+
+Scenario ScenarioGenerator::Generate(ScenarioType type, int vehicles_count, mt19937 &random) const {
+  const int lanes_count = MapUtils::LanesCount();
+  uniform_real_distribution<double> ego_s_distribution(MIN_EGO_S, MAX_EGO_S);
+  uniform_real_distribution<double> unit_distribution(0, 1);
+
+  Scenario scenario;
+  scenario.type = type;
+  scenario.ego_s = ego_s_distribution(random);
+  //PathPlanner, like Simulator, starts in lane 1
+  const int ego_lane = min(1, lanes_count - 1);
+  scenario.ego_d = MapUtils::GetdValueForLaneCenter(ego_lane);
+  scenario.vehicles.reserve(vehicles_count);
+
+  switch (type) {
+    case DENSE_PLATOON: {
+      //platoon starts a bit ahead of ego vehicle and fills every lane
+      double speed = MEAN_SPEED - 5 + 2 * unit_distribution(random);
+      int per_lane = max(1, vehicles_count / lanes_count);
+      for (int lane = 0; lane < lanes_count; ++lane) {
+        double s = scenario.ego_s + 30 + 10 * unit_distribution(random);
+        double d = MapUtils::GetdValueForLaneCenter(lane);
+        for (int i = 0; i < per_lane && scenario.vehicles.size() < vehicles_count; ++i) {
+          SimulatedVehicle vehicle = { s, d, speed + unit_distribution(random) - 0.5, d, 0, 0 };
+          scenario.vehicles.push_back(vehicle);
+          s += PLATOON_GAP + 5 * unit_distribution(random);
+        }
+      }
+      break;
+    }
+    case CUT_IN: {
+      //a few vehicles just ahead in neighbor lanes move into ego lane at random times
+      int cut_ins_count = max(1, vehicles_count / 4);
+      for (int i = 0; i < cut_ins_count; ++i) {
+        int direction = unit_distribution(random) < 0.5 ? -1 : 1;
+        if (ego_lane + direction < 0 || ego_lane + direction >= lanes_count) {
+          direction = -direction;
+        }
+        int lane = ego_lane + direction;
+        double s = scenario.ego_s + 10 + 60 * unit_distribution(random);
+        if (lane < 0 || lane >= lanes_count || !IsFree(scenario, lane, s, MIN_GAP)) {
+          continue;
+        }
+
+        double d = MapUtils::GetdValueForLaneCenter(lane);
+        SimulatedVehicle vehicle = { s, d, MEAN_SPEED - 6 * unit_distribution(random), scenario.ego_d,
+                                     CUT_IN_D_RATE, 6 * unit_distribution(random) };
+        scenario.vehicles.push_back(vehicle);
+      }
+      AddBackgroundTraffic(scenario, vehicles_count - scenario.vehicles.size(), random);
+      break;
+    }
+    case STALLED_CAR: {
+      double s = scenario.ego_s + 60 + 140 * unit_distribution(random);
+      SimulatedVehicle vehicle = { s, scenario.ego_d, 0, scenario.ego_d, 0, 0 };
+      scenario.vehicles.push_back(vehicle);
+      AddBackgroundTraffic(scenario, vehicles_count - 1, random);
+      break;
+    }
+    default:
+      AddBackgroundTraffic(scenario, vehicles_count, random);
+      break;
+  }
+
+  return scenario;
+}
+
+void ScenarioGenerator::Step(double t, double dt, Scenario &scenario) {
+  for (int i = 0; i < scenario.vehicles.size(); ++i) {
+    SimulatedVehicle &vehicle = scenario.vehicles[i];
+    vehicle.s += vehicle.v * dt;
+    if (t >= vehicle.start_t && vehicle.d != vehicle.target_d) {
+      double step = vehicle.d_rate * dt;
+      if (fabs(vehicle.target_d - vehicle.d) <= step) {
+        vehicle.d = vehicle.target_d;
+      } else {
+        vehicle.d += vehicle.target_d > vehicle.d ? step : -step;
+      }
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * scenario_generator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SCENARIO_GENERATOR_H_
+#define SCENARIO_GENERATOR_H_
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum ScenarioType {
+  //few vehicles, well spread
+  FREE_ROAD,
+  //closely spaced vehicles at similar speed in every lane ahead
+  DENSE_PLATOON,
+  //vehicles in neighbor lanes moving into ego lane just ahead
+  CUT_IN,
+  //stopped vehicles ahead in ego lane
+  STALLED_CAR,
+  SCENARIO_TYPES_COUNT
+};
+
+/**
+ * A vehicle of synthetic traffic. It drives at constant
+ * velocity and moves towards target_d at d_rate once start_t has passed
+ */
+struct SimulatedVehicle {
+  double s;
+  double d;
+  double v;
+  double target_d;
+  double d_rate;
+  double start_t;
+};
+
+struct Scenario {
+  ScenarioType type;
+  double ego_s;
+  double ego_d;
+  vector<SimulatedVehicle> vehicles;
+};
+
+/**
+ * Generates synthetic traffic around ego vehicle. Traffic of each type
+ * is drawn from its own distributions, same random engine state always
+ * gives same scenario.
+ */
+class ScenarioGenerator {
+public:
+  ScenarioGenerator();
+  virtual ~ScenarioGenerator();
+
+  Scenario Generate(ScenarioType type, int vehicles_count, mt19937 &random) const;
+
+  /**
+   * Moves vehicles dt seconds ahead
+   */
+  static void Step(double t, double dt, Scenario &scenario);
+
+  static string TypeName(ScenarioType type);
+
+private:
+  /**
+   * Adds vehicles in random lanes and positions ahead of ego vehicle, keeping
+   * MIN_GAP between vehicles of same lane
+   */
+  void AddBackgroundTraffic(Scenario &scenario, int vehicles_count, mt19937 &random) const;
+  bool IsFree(const Scenario &scenario, int lane, double s, double gap) const;
+
+  //ego vehicle starts far enough from end of track that it does not wrap around
+  const double MIN_EGO_S = 200;
+  const double MAX_EGO_S = 5000;
+  const double MIN_GAP = 15;
+  const double MEAN_SPEED = 20; // m/s
+  const double SPEED_DEVIATION = 3;
+  const double PLATOON_GAP = 10;
+  const double CUT_IN_D_RATE = 1.5; // m/s
+};
+
+#endif /* SCENARIO_GENERATOR_H_ */
@@ -0,0 +1,88 @@
+/*
+ * work_stealing_pool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <thread>
+#include "work_stealing_pool.h"
+
+WorkStealingPool::WorkStealingPool(int threads_count)
+    : threads_count_(max(1, threads_count)) {
+  for (int i = 0; i < threads_count_; ++i) {
+    queues_.push_back(unique_ptr<TaskQueue>(new TaskQueue()));
+  }
+  stolen_counts_.assign(threads_count_, 0);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+}
+
+int WorkStealingPool::ThreadsCount() const {
+  return threads_count_;
+}
+
+int WorkStealingPool::StolenCount() const {
+  int stolen_count = 0;
+  for (int i = 0; i < threads_count_; ++i) {
+    stolen_count += stolen_counts_[i];
+  }
+  return stolen_count;
+}
+
+void WorkStealingPool::Run(int tasks_count, const function<void(int, int)> &task) {
+  //deal tasks round robin so that every thread starts with a share of each kind
+  for (int i = 0; i < tasks_count; ++i) {
+    queues_[i % threads_count_]->tasks.push_back(i);
+  }
+  stolen_counts_.assign(threads_count_, 0);
+
+  vector<thread> threads;
+  for (int worker = 1; worker < threads_count_; ++worker) {
+    threads.push_back(thread(&WorkStealingPool::Work, this, worker, cref(task)));
+  }
+  //calling thread is worker 0
+  Work(0, task);
+
+  for (int i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
+
+void WorkStealingPool::Work(int worker, const function<void(int, int)> &task) {
+  int task_index;
+  while (PopOwn(worker, task_index) || Steal(worker, task_index)) {
+    task(worker, task_index);
+  }
+}
+
+bool WorkStealingPool::PopOwn(int worker, int &task_index) {
+  TaskQueue &queue = *queues_[worker];
+  lock_guard<mutex> guard(queue.lock);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+
+  task_index = queue.tasks.back();
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingPool::Steal(int worker, int &task_index) {
+  //no tasks are added during Run() so if every queue
+  //is empty when we look at it, there is nothing left
+  for (int i = 1; i < threads_count_; ++i) {
+    TaskQueue &queue = *queues_[(worker + i) % threads_count_];
+    lock_guard<mutex> guard(queue.lock);
+    if (!queue.tasks.empty()) {
+      task_index = queue.tasks.front();
+      queue.tasks.pop_front();
+      ++stolen_counts_[worker];
+      return true;
+    }
+  }
+
+  return false;
+}
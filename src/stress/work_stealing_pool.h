@@ -0,0 +1,59 @@
+/*
+ * work_stealing_pool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef WORK_STEALING_POOL_H_
+#define WORK_STEALING_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Runs a batch of independent tasks on a fixed number of threads. Tasks are
+ * dealt out to per-thread queues up front, each thread takes tasks from back
+ * of its own queue and, when it runs dry, steals from front of other queues,
+ * so threads which got cheap tasks help the ones which got expensive ones.
+ */
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(int threads_count);
+  virtual ~WorkStealingPool();
+
+  /**
+   * Calls task(worker, task_index) for every task_index in [0, tasks_count)
+   * and returns when all of them are done. worker is in [0, ThreadsCount())
+   * and is the same for all tasks running on one thread.
+   */
+  void Run(int tasks_count, const function<void(int, int)> &task);
+
+  int ThreadsCount() const;
+
+  /**
+   * @returns number of tasks taken from another thread's queue in last Run()
+   */
+  int StolenCount() const;
+
+private:
+  struct TaskQueue {
+    mutex lock;
+    deque<int> tasks;
+  };
+
+  void Work(int worker, const function<void(int, int)> &task);
+  bool PopOwn(int worker, int &task_index);
+  bool Steal(int worker, int &task_index);
+
+  const int threads_count_;
+  vector<unique_ptr<TaskQueue> > queues_;
+  vector<int> stolen_counts_;
+};
+
+#endif /* WORK_STEALING_POOL_H_ */
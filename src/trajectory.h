@@ -8,61 +8,75 @@
 #ifndef TRAJECTORY_H_
 #define TRAJECTORY_H_
 
+#include <utility>
 #include <vector>
+#include "arena.h"
 
 using namespace std;
 
+//trajectory values live in planner workspace arena when created
+//during a planning cycle, or on heap when created without one
+typedef ArenaVector<double> TrajectoryValues;
+
 /**
  * A passive object to contain Jerk Minimized Trajectory information
  */
 
 struct CartesianTrajectory {
   //cartesian coordinates
-  vector<double> x_values;
-  vector<double> y_values;
+  TrajectoryValues x_values;
+  TrajectoryValues y_values;
   double reference_velocity;
   int lane;
 
-  CartesianTrajectory(const vector<double> &x_values,
-                      const vector<double> &y_values,
+  CartesianTrajectory(TrajectoryValues x_values,
+                      TrajectoryValues y_values,
                       double reference_velocity,
-                      int lane) {
-    this->x_values = x_values;
-    this->y_values = y_values;
+                      int lane)
+      : x_values(std::move(x_values)),
+        y_values(std::move(y_values)) {
+    //values are moved in, callers hand over their buffers and their arena
     this->reference_velocity = reference_velocity;
     this->lane = lane;
   }
 
-  CartesianTrajectory ExtractTrajectory(int points_count=50) {
-    vector<double> new_x_values(this->x_values.begin(), this->x_values.begin() + points_count);
-    vector<double> new_y_values(this->y_values.begin(), this->y_values.begin() + points_count);
+  CartesianTrajectory ExtractTrajectory(int points_count=50) const {
+    //copy goes to same arena as this trajectory, a plain copy would go to heap
+    TrajectoryValues new_x_values(this->x_values.begin(), this->x_values.begin() + points_count,
+                                    this->x_values.get_allocator());
+    TrajectoryValues new_y_values(this->y_values.begin(), this->y_values.begin() + points_count,
+                                    this->y_values.get_allocator());
 
-    return CartesianTrajectory(new_x_values, new_y_values, reference_velocity, lane);
+    return CartesianTrajectory(std::move(new_x_values), std::move(new_y_values), reference_velocity, lane);
   }
 };
 
 struct FrenetTrajectory {
   //Frenet coordinates
-  vector<double> s_values;
-  vector<double> d_values;
+  TrajectoryValues s_values;
+  TrajectoryValues d_values;
   double reference_velocity;
   int lane;
 
-  FrenetTrajectory(const vector<double> &s_values,
-                   const vector<double> &d_values,
+  FrenetTrajectory(TrajectoryValues s_values,
+                   TrajectoryValues d_values,
                    double reference_velocity,
-                   int lane) {
-    this->s_values = s_values;
-    this->d_values = d_values;
+                   int lane)
+      : s_values(std::move(s_values)),
+        d_values(std::move(d_values)) {
+    //values are moved in, callers hand over their buffers and their arena
     this->reference_velocity = reference_velocity;
     this->lane = lane;
   }
 
-  FrenetTrajectory ExtractTrajectory(int points_count=50) {
-    vector<double> new_s_values(this->s_values.begin(), this->s_values.begin() + points_count);
-    vector<double> new_d_values(this->d_values.begin(), this->d_values.begin() + points_count);
+  FrenetTrajectory ExtractTrajectory(int points_count=50) const {
+    //copy goes to same arena as this trajectory, a plain copy would go to heap
+    TrajectoryValues new_s_values(this->s_values.begin(), this->s_values.begin() + points_count,
+                                    this->s_values.get_allocator());
+    TrajectoryValues new_d_values(this->d_values.begin(), this->d_values.begin() + points_count,
+                                    this->d_values.get_allocator());
 
-    return FrenetTrajectory(new_s_values, new_d_values, reference_velocity, lane);
+    return FrenetTrajectory(std::move(new_s_values), std::move(new_d_values), reference_velocity, lane);
   }
 };
 
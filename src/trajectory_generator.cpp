@@ -6,104 +6,93 @@
  */
 
 #include <math.h>
+#include <algorithm>
 #include "utils.h"
 #include "map_utils.h"
 #include "spline.h"
 #include "trajectory_generator.h"
 
-TrajectoryGenerator::TrajectoryGenerator() {
-  // TODO Auto-generated constructor stub
+namespace {
 
-}
-
-TrajectoryGenerator::~TrajectoryGenerator() {
-  // TODO Auto-generated destructor stub
-}
+/**
+ * Vehicle coordinate frame splines are fitted in. Its origin is where new
+ * points start (end of previous path, or ego vehicle if there is none) and
+ * x-axis points along ref_yaw.
+ */
+struct SplineFrame {
+  double x;
+  double y;
+  double yaw;
+  double s;
+  double cos_yaw;
+  double sin_yaw;
+  //first two spline points, one before origin and origin itself
+  double start_x[2];
+  double start_y[2];
+
+  /**
+   * Same as MapUtils::TransformToVehicleCoordinates() but with cos and sin
+   * of yaw computed once for all points
+   */
+  void ToVehicleCoordinates(double &point_x, double &point_y) const {
+    double shift_x = point_x - x;
+    double shift_y = point_y - y;
+    point_x = shift_x * cos_yaw + shift_y * sin_yaw;
+    point_y = -(shift_x * sin_yaw) + shift_y * cos_yaw;
+  }
 
-CartesianTrajectory TrajectoryGenerator::GenerateTrajectory(const Vehicle &ego_vehicle,
-                                     const vector<double> &prev_path_x,
-                                     const vector<double> &prev_path_y,
-                                     double prev_path_last_s,
-                                     double prev_path_last_d,
-                                     int proposed_lane,
-                                     double ref_velocity) {
+  /**
+   * Same as MapUtils::TransformFromVehicleToMapCoordinates()
+   */
+  void ToMapCoordinates(double &point_x, double &point_y) const {
+    double rotated_x = point_x * cos_yaw - point_y * sin_yaw;
+    double rotated_y = point_x * sin_yaw + point_y * cos_yaw;
+    point_x = rotated_x + x;
+    point_y = rotated_y + y;
+  }
+};
 
+SplineFrame MakeSplineFrame(const Vehicle &ego_vehicle,
+                            const vector<double> &prev_path_x,
+                            const vector<double> &prev_path_y,
+                            double prev_path_last_s) {
   const int prev_path_size = prev_path_x.size();
 
-  double ref_x = ego_vehicle.x;
-  double ref_y = ego_vehicle.y;
-  double ref_yaw = ego_vehicle.yaw;
-
-  double ref_s = ego_vehicle.s;
-  double ref_d = ego_vehicle.d;
+  SplineFrame frame;
+  frame.x = ego_vehicle.x;
+  frame.y = ego_vehicle.y;
+  frame.yaw = ego_vehicle.yaw;
+  frame.s = ego_vehicle.s;
 
   //previous path is not empty that means simulator has
   //not traversed it yet and car is still in somewhere on that path
   //we have to provide new path so start from previous path end
   //hence previous path end point will become the new reference point to start
   if (prev_path_size > 0) {
-    ref_s = prev_path_last_s;
-    ref_d = prev_path_last_d;
+    frame.s = prev_path_last_s;
   }
 
-  //make vectors of temporary points first
-  //from which we will extrapolate actual points
-  vector<double> points_x;
-  vector<double> points_y;
-
   if (prev_path_size < 2) {
     //predict x,y before ref_x, ref_y
     //as delta_t = 1 so
-    double prev_x = ref_x - cos(ref_yaw);
-    double prev_y = ref_y - sin(ref_yaw);
-
-    //add (ref_x, ref_y) and (prev_x, prev_y) to points list
-    points_x.push_back(prev_x);
-    points_y.push_back(prev_y);
-
-    points_x.push_back(ref_x);
-    points_y.push_back(ref_y);
+    frame.start_x[0] = frame.x - cos(frame.yaw);
+    frame.start_y[0] = frame.y - sin(frame.yaw);
   } else {
-    //previous path is not empty that means simulator has
-    //not traversed it yet and car is still in somewhere on that path
-    //we have to provide new path so start from previous path end
-    //hence previous path end point will become the new reference point to start
-    ref_x = prev_path_x[prev_path_size-1];
-    ref_y = prev_path_y[prev_path_size-1];
+    frame.x = prev_path_x[prev_path_size-1];
+    frame.y = prev_path_y[prev_path_size-1];
 
     //we need to calculate ref_yaw which is tangent between last and second
     //last point of the previous path so get the second last point
-    double x_before_ref_x = prev_path_x[prev_path_size-2];
-    double y_before_ref_y = prev_path_y[prev_path_size-2];
+    frame.start_x[0] = prev_path_x[prev_path_size-2];
+    frame.start_y[0] = prev_path_y[prev_path_size-2];
 
     //now take tangent
-    ref_yaw = atan2(ref_y - y_before_ref_y, ref_x - x_before_ref_x);
-
-    //add these 2 points to list of points as well
-    points_x.push_back(x_before_ref_x);
-    points_y.push_back(y_before_ref_y);
-
-    points_x.push_back(ref_x);
-    points_y.push_back(ref_y);
+    frame.yaw = atan2(frame.y - frame.start_y[0], frame.x - frame.start_x[0]);
   }
-
-  //add 3 more equally distant (30 meters) points (from each other) for better extrapolation
-  //AND to also consider LANE CHANGE
-  //for ease we will add them as Frenet coordinates
-  double d_value_for_proposed_lane = MapUtils::GetdValueForLaneCenter(proposed_lane);
-  vector<double> wp0 = MapUtils::getXY(ref_s + 30, d_value_for_proposed_lane);
-  vector<double> wp1 = MapUtils::getXY(ref_s + 60, d_value_for_proposed_lane);
-  vector<double> wp2 = MapUtils::getXY(ref_s + 90, d_value_for_proposed_lane);
-
-  //add these 3 points to way points list
-  points_x.push_back(wp0[0]);
-  points_y.push_back(wp0[1]);
-
-  points_x.push_back(wp1[0]);
-  points_y.push_back(wp1[1]);
-
-  points_x.push_back(wp2[0]);
-  points_y.push_back(wp2[1]);
+  frame.start_x[1] = frame.x;
+  frame.start_y[1] = frame.y;
+  frame.cos_yaw = cos(frame.yaw);
+  frame.sin_yaw = sin(frame.yaw);
 
   //to make our math easier let's convert these points from
   //Cartesian/Map coordinates to Vehicle coordinates
@@ -111,83 +100,371 @@ CartesianTrajectory TrajectoryGenerator::GenerateTrajectory(const Vehicle &ego_v
   //you will get same y-values for different x-axis.
   //To avoid that we convert to vehicle coordinates which
   //don't have these issues
-  for (int i = 0; i < points_x.size(); ++i) {
-    MapUtils::TransformToVehicleCoordinates(ref_x, ref_y, ref_yaw, points_x[i], points_y[i]);
+  for (int i = 0; i < 2; ++i) {
+    frame.ToVehicleCoordinates(frame.start_x[i], frame.start_y[i]);
   }
 
+  return frame;
+}
+
+/**
+ * Fits spline through points (vehicle coordinates)
+ * @returns distance on x-axis per meter along the spline
+ */
+double FitSpline(const vector<double> &points_x, const vector<double> &points_y, tk::spline &spline) {
   //fit a spline function which makes sure the curve/line passes through
   //each given point
-  tk::spline spline;
   spline.set_points(points_x, points_y);
 
-  //our reference velocity is in miles/hour we need to
-  //convert our desired/reference velocity in meters/second for ease
-  //Remember 1 mile = 1.69 km = 1609.34 meters
-  //and 1 hours = 60 mins * 60 secs = 3600
-  const double ref_velocity_meters_per_second = ref_velocity * (1609.34 / 3600);
-
   //as we need to find the space between points on spline to
-  //to keep our desired velocity, to achieve that
+  //to keep desired velocity of each point, to achieve that
   //we can define some target on x-axis, target_x,
-  //and then find how many points should be there in between
-  //x-axis=0 and x-axis=target_x so that if we keep our desired
-  //velocity and each time step is 0.02 (20 ms) long then we achieve
-  //our target distance between 0 to target_x, target_dist
+  //and find how long the spline is between x-axis=0 and
+  //x-axis=target_x, target_dist. Then moving d meters along
+  //the curve is roughly moving d * target_x / target_dist on x-axis
   //
   //formula: V = d / t
   //as each timestep = 0.02 secs so
-  //formula: V = d / (0.02 * N)
-  //--> ref_v = target_dist / (0.02 * N)
-  //--> N = target_dist / (0.02 * ref_v)
+  //--> d = 0.02 * V
+  //--> point_space = 0.02 * V * target_x / target_dist
   double target_x = 30;
   double target_y = spline(target_x);
   double target_distance = Utils::euclidean(0, 0, target_x, target_y);
+  return target_x / target_distance;
+}
 
-  //here N is: number of points from 0 to target_dist_x
-  //
-  //--> point_space = target_x / N
-  const double N = target_distance / (0.02 * ref_velocity_meters_per_second);
+/**
+ * Spline of a lane fitted in an earlier cycle, with frame it was fitted in
+ */
+struct CachedLaneSpline {
+  bool is_valid;
+  //quantized s and yaw of frame
+  long s_key;
+  long yaw_key;
+  SplineFrame frame;
+  tk::spline spline;
+  double x_per_meter;
+};
+
+//quantization steps of cache keys. Cached spline of a lane is refitted
+//at least every CACHE_S_STEP meters so its anchors stay about 30, 60 and
+//90 meters ahead
+const double CACHE_S_STEP = 10; // m
+const double CACHE_YAW_STEP = 0.1; // rad
+//how far previous path may be off cached spline for it to still be used
+const double CACHE_TOLERANCE = 1e-6; // m
+
+/**
+ * A cached spline can only be used when last points of previous path lie
+ * on it, that is when they were generated from it in an earlier cycle.
+ * New points then continue on same curve and there is no joint at all.
+ * @returns x (cached frame) on cached spline where new points start,
+ * negative if it can't be used
+ */
+double FindCachedSplineStart(const CachedLaneSpline &cached, long s_key, long yaw_key,
+                             const vector<double> &prev_path_x, const vector<double> &prev_path_y) {
+  const int prev_path_size = prev_path_x.size();
+  if (!cached.is_valid || cached.s_key != s_key || cached.yaw_key != yaw_key || prev_path_size < 2) {
+    return -1;
+  }
+
+  double last_x = prev_path_x[prev_path_size - 1];
+  double last_y = prev_path_y[prev_path_size - 1];
+  double before_last_x = prev_path_x[prev_path_size - 2];
+  double before_last_y = prev_path_y[prev_path_size - 2];
+  cached.frame.ToVehicleCoordinates(last_x, last_y);
+  cached.frame.ToVehicleCoordinates(before_last_x, before_last_y);
+
+  //previous path must be going forward along spline and be on it
+  if (last_x < 0 || last_x <= before_last_x
+      || fabs(cached.spline(last_x) - last_y) > CACHE_TOLERANCE
+      || fabs(cached.spline(before_last_x) - before_last_y) > CACHE_TOLERANCE) {
+    return -1;
+  }
+
+  return last_x;
+}
+
+}
+
+struct TrajectoryGenerator::LaneSplineCache {
+  /**
+   * Makes sure there is a spline for each of proposed lanes that previous
+   * path ends on, lanes whose cached spline can't be used are refitted.
+   * start_x is then where new points start on spline of each lane (its frame)
+   */
+  void Fit(const SplineFrame &frame,
+           const vector<double> &prev_path_x,
+           const vector<double> &prev_path_y,
+           const ArenaVector<int> &proposed_lanes);
+
+  //indexed by lane
+  vector<CachedLaneSpline> splines;
+  vector<double> start_x;
+  //kept between calls so they keep their capacity
+  vector<double> points_x;
+  vector<double> points_y;
+  vector<double> candidate_x;
+  //spline of single lane GenerateTrajectory(), refitted every call
+  tk::spline spline;
+};
+
+void TrajectoryGenerator::LaneSplineCache::Fit(const SplineFrame &frame,
+                                               const vector<double> &prev_path_x,
+                                               const vector<double> &prev_path_y,
+                                               const ArenaVector<int> &proposed_lanes) {
+  const int lanes_count = proposed_lanes.size();
+  const long s_key = long(floor(frame.s / CACHE_S_STEP));
+  const long yaw_key = lround(frame.yaw / CACHE_YAW_STEP);
+
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    if ((int) splines.size() <= proposed_lanes[lane]) {
+      CachedLaneSpline invalid = CachedLaneSpline();
+      invalid.is_valid = false;
+      splines.resize(proposed_lanes[lane] + 1, invalid);
+    }
+  }
+  start_x.resize(lanes_count);
+
+  //anchors are 30, 60 and 90 meters ahead in center of each lane. Reference
+  //line is looked up once per anchor s, lanes only differ by offset along
+  //normal. Lookups are only done if a lane needs to be refitted
+  const int anchors_count = 3;
+  double reference_x[anchors_count];
+  double reference_y[anchors_count];
+  double normal_x[anchors_count];
+  double normal_y[anchors_count];
+  bool has_reference_points = false;
+
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    CachedLaneSpline &cached = splines[proposed_lanes[lane]];
+    start_x[lane] = FindCachedSplineStart(cached, s_key, yaw_key, prev_path_x, prev_path_y);
+    if (start_x[lane] >= 0) {
+      continue;
+    }
+
+    if (!has_reference_points) {
+      for (int i = 0; i < anchors_count; ++i) {
+        MapUtils::GetReferencePoint(frame.s + 30 * (i + 1), reference_x[i], reference_y[i], normal_x[i], normal_y[i]);
+      }
+      has_reference_points = true;
+    }
+
+    points_x.assign(frame.start_x, frame.start_x + 2);
+    points_y.assign(frame.start_y, frame.start_y + 2);
+
+    double d = MapUtils::GetdValueForLaneCenter(proposed_lanes[lane]);
+    for (int i = 0; i < anchors_count; ++i) {
+      double wp_x = reference_x[i] + d * normal_x[i];
+      double wp_y = reference_y[i] + d * normal_y[i];
+      frame.ToVehicleCoordinates(wp_x, wp_y);
+      points_x.push_back(wp_x);
+      points_y.push_back(wp_y);
+    }
+
+    cached.is_valid = true;
+    cached.s_key = s_key;
+    cached.yaw_key = yaw_key;
+    cached.frame = frame;
+    cached.x_per_meter = FitSpline(points_x, points_y, cached.spline);
+    start_x[lane] = 0;
+  }
+}
+
+TrajectoryGenerator::TrajectoryGenerator()
+    : lane_spline_cache_(new LaneSplineCache()) {
+
+}
+
+TrajectoryGenerator::~TrajectoryGenerator() {
+  // TODO Auto-generated destructor stub
+}
+
+CartesianTrajectory TrajectoryGenerator::GenerateTrajectory(const Vehicle &ego_vehicle,
+                                     const vector<double> &prev_path_x,
+                                     const vector<double> &prev_path_y,
+                                     double prev_path_last_s,
+                                     double prev_path_last_d,
+                                     int proposed_lane,
+                                     const TrajectoryValues &velocities,
+                                     PlannerWorkspace &workspace) {
+
+  //add 3 more equally distant (30 meters) points (from each other) for better extrapolation
+  //AND to also consider LANE CHANGE
+  //for ease we will add them as Frenet coordinates
+  double d_value_for_proposed_lane = MapUtils::GetdValueForLaneCenter(proposed_lane);
+  TrajectoryValues anchor_s_offsets = workspace.MakeVector<double>(3);
+  TrajectoryValues anchor_d_values = workspace.MakeVector<double>(3);
+  for (int i = 1; i <= 3; ++i) {
+    anchor_s_offsets.push_back(30 * i);
+    anchor_d_values.push_back(d_value_for_proposed_lane);
+  }
+
+  return GenerateTrajectory(ego_vehicle, prev_path_x, prev_path_y, prev_path_last_s, prev_path_last_d,
+                            anchor_s_offsets, anchor_d_values, proposed_lane, velocities, workspace);
+}
 
-  //divide the range between 0 to target_x to get
-  //the space each point in this range have in between
-  //to reach target_x with desired velocity
-  const double point_space = target_x / N;
+CartesianTrajectory TrajectoryGenerator::GenerateTrajectory(const Vehicle &ego_vehicle,
+                                     const vector<double> &prev_path_x,
+                                     const vector<double> &prev_path_y,
+                                     double prev_path_last_s,
+                                     double prev_path_last_d,
+                                     const TrajectoryValues &anchor_s_offsets,
+                                     const TrajectoryValues &anchor_d_values,
+                                     int proposed_lane,
+                                     const TrajectoryValues &velocities,
+                                     PlannerWorkspace &workspace) {
 
-  vector<double> next_x_vals;
-  vector<double> next_y_vals;
+  const int prev_path_size = prev_path_x.size();
+  SplineFrame frame = MakeSplineFrame(ego_vehicle, prev_path_x, prev_path_y, prev_path_last_s);
+
+  //make vectors of temporary points first
+  //from which we will extrapolate actual points.
+  //These and the spline are kept between calls so
+  //they keep their capacity and fitting does not allocate
+  vector<double> &points_x = lane_spline_cache_->points_x;
+  vector<double> &points_y = lane_spline_cache_->points_y;
+  points_x.assign(frame.start_x, frame.start_x + 2);
+  points_y.assign(frame.start_y, frame.start_y + 2);
+
+  //add anchor points ahead, given as Frenet coordinates
+  const int anchors_count = anchor_s_offsets.size();
+  for (int i = 0; i < anchors_count; ++i) {
+    double wp_x;
+    double wp_y;
+    MapUtils::getXY(frame.s + anchor_s_offsets[i], anchor_d_values[i], wp_x, wp_y);
+    frame.ToVehicleCoordinates(wp_x, wp_y);
+
+    //add this point to way points list
+    points_x.push_back(wp_x);
+    points_y.push_back(wp_y);
+  }
+
+  tk::spline &spline = lane_spline_cache_->spline;
+  const double x_per_meter = FitSpline(points_x, points_y, spline);
+
+  //trajectory points are allocated from this cycle's workspace
+  const int points_count = max(50, prev_path_size);
+  TrajectoryValues next_x_vals = workspace.MakeVector<double>(points_count);
+  TrajectoryValues next_y_vals = workspace.MakeVector<double>(points_count);
 
   //now we are ready to generate points from spline
   //but first let's add points of previous path that are
   //not yet traversed by the simulator
-  for (int i = 0; i < prev_path_size; ++i) {
-    next_x_vals.push_back(prev_path_x[i]);
-    next_y_vals.push_back(prev_path_y[i]);
-  }
+  next_x_vals.insert(next_x_vals.end(), prev_path_x.begin(), prev_path_x.end());
+  next_y_vals.insert(next_y_vals.end(), prev_path_y.begin(), prev_path_y.end());
 
   //now generate remaining points
-  //in total we need 50 points (50 frames (each frame of 20ms) per second
-  //and in each (after 20ms) simulator moves to next point in list)
-  //so providing 50 points will cover 1 second window.
-  //As we have already added left-over points from previous path that
-  //simulator have not yet traversed so we will only add (50 - prev_path_size)
-  //points. All points will be generated starting from ref_x, which is 0
-  //because we are in vehicle coordinates so (ref_x, ref_y) = (0, 0),
-  //and will have `point_space` gap between them
-  double start_x = 0;
-  for (int i = 1; i <= 50 - prev_path_size; ++i) {
-    double x = start_x + (i * point_space);
-    //get corresponding y-value on spline
-    double y = spline(x);
-
-    //convert each point back to Map-Coordinates as
-    //Simulator expects points in Map-Coordinates
-    MapUtils::TransformFromVehicleToMapCoordinates(ref_x, ref_y, ref_yaw, x, y);
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  const int velocities_count = velocities.size();
+  double x = 0;
+  for (int i = 0; i < 50 - prev_path_size; ++i) {
+    double velocity = velocities[min(i, velocities_count - 1)] * meters_per_second_in_mph;
+    x += 0.02 * velocity * x_per_meter;
+
+    //get corresponding y-value on spline and convert it back to
+    //Map-Coordinates as Simulator expects points in Map-Coordinates
+    double point_x = x;
+    double point_y = spline(x);
+    frame.ToMapCoordinates(point_x, point_y);
 
     //add this point to the list of points
-    next_x_vals.push_back(x);
-    next_y_vals.push_back(y);
+    next_x_vals.push_back(point_x);
+    next_y_vals.push_back(point_y);
   }
 
-  return CartesianTrajectory(next_x_vals, next_y_vals, ref_velocity, proposed_lane);
+  //reference velocity of trajectory is the one it ends with
+  double ref_velocity = velocities.empty() ? 0 : velocities.back();
+  return CartesianTrajectory(std::move(next_x_vals), std::move(next_y_vals), ref_velocity, proposed_lane);
 }
 
+ArenaVector<CartesianTrajectory> TrajectoryGenerator::GenerateTrajectories(const Vehicle &ego_vehicle,
+                                                                           const vector<double> &prev_path_x,
+                                                                           const vector<double> &prev_path_y,
+                                                                           double prev_path_last_s,
+                                                                           double prev_path_last_d,
+                                                                           const ArenaVector<int> &proposed_lanes,
+                                                                           const ArenaVector<TrajectoryValues> &velocity_variants,
+                                                                           PlannerWorkspace &workspace) {
+  const int prev_path_size = prev_path_x.size();
+  const int lanes_count = proposed_lanes.size();
+  const int variants_count = velocity_variants.size();
+  ArenaVector<CartesianTrajectory> trajectories = workspace.MakeVector<CartesianTrajectory>(lanes_count * variants_count);
+  if (lanes_count == 0 || variants_count == 0) {
+    return trajectories;
+  }
+
+  //reference point and yaw, and first two spline points, are same for all lanes
+  SplineFrame frame = MakeSplineFrame(ego_vehicle, prev_path_x, prev_path_y, prev_path_last_s);
+
+  //one spline per lane, kept between calls and cycles. Path we sent
+  //last cycle ends on spline of lane we selected, so that one is
+  //usually reused as is, others are refitted unless that was
+  //already done by PrecomputeSplines() between cycles
+  lane_spline_cache_->Fit(frame, prev_path_x, prev_path_y, proposed_lanes);
+  const vector<CachedLaneSpline> &cache = lane_spline_cache_->splines;
+  const vector<double> &start_x = lane_spline_cache_->start_x;
+
+  //all candidates start with previous path, one candidate
+  //per velocity variant of each lane
+  const int points_count = max(50, prev_path_size);
+  for (int lane = 0; lane < lanes_count; ++lane) {
+    for (int variant = 0; variant < variants_count; ++variant) {
+      const TrajectoryValues &velocities = velocity_variants[variant];
+      TrajectoryValues next_x_vals = workspace.MakeVector<double>(points_count);
+      TrajectoryValues next_y_vals = workspace.MakeVector<double>(points_count);
+      next_x_vals.insert(next_x_vals.end(), prev_path_x.begin(), prev_path_x.end());
+      next_y_vals.insert(next_y_vals.end(), prev_path_y.begin(), prev_path_y.end());
+      double ref_velocity = velocities.empty() ? 0 : velocities.back();
+      trajectories.push_back(CartesianTrajectory(std::move(next_x_vals), std::move(next_y_vals), ref_velocity,
+                                                 proposed_lanes[lane]));
+    }
+  }
+
+  //then new points of all candidates are filled together. Spline of a lane
+  //does not depend on velocity, variants only space points differently on it
+  const double meters_per_second_in_mph = 1609.34 / 3600;
+  vector<double> &candidate_x = lane_spline_cache_->candidate_x;
+  candidate_x.resize(lanes_count * variants_count);
+  for (int candidate = 0; candidate < lanes_count * variants_count; ++candidate) {
+    candidate_x[candidate] = start_x[candidate / variants_count];
+  }
+  for (int i = 0; i < 50 - prev_path_size; ++i) {
+    for (int variant = 0; variant < variants_count; ++variant) {
+      const TrajectoryValues &velocities = velocity_variants[variant];
+      const int velocities_count = velocities.size();
+      double velocity = velocities[min(i, velocities_count - 1)] * meters_per_second_in_mph;
+
+      for (int lane = 0; lane < lanes_count; ++lane) {
+        const CachedLaneSpline &cached = cache[proposed_lanes[lane]];
+        const int candidate = lane * variants_count + variant;
+        candidate_x[candidate] += 0.02 * velocity * cached.x_per_meter;
+
+        double point_x = candidate_x[candidate];
+        double point_y = cached.spline(point_x);
+        cached.frame.ToMapCoordinates(point_x, point_y);
+
+        trajectories[candidate].x_values.push_back(point_x);
+        trajectories[candidate].y_values.push_back(point_y);
+      }
+    }
+  }
+
+  return trajectories;
+}
+
+void TrajectoryGenerator::PrecomputeSplines(const Vehicle &ego_vehicle,
+                                            const vector<double> &path_x,
+                                            const vector<double> &path_y,
+                                            double path_last_s,
+                                            double path_last_d,
+                                            const ArenaVector<int> &proposed_lanes) {
+  //frame only depends on where path ends, so it is the same
+  //however many points Simulator drives through meanwhile
+  if (path_x.size() < 2) {
+    return;
+  }
+  SplineFrame frame = MakeSplineFrame(ego_vehicle, path_x, path_y, path_last_s);
+
+  lane_spline_cache_->Fit(frame, path_x, path_y, proposed_lanes);
+}
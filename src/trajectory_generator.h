@@ -8,9 +8,11 @@
 #ifndef TRAJECTORY_GENERATOR_H_
 #define TRAJECTORY_GENERATOR_H_
 
+#include <memory>
 #include <vector>
 #include "vehicle.h"
 #include "trajectory.h"
+#include "planner_workspace.h"
 
 using namespace std;
 
@@ -19,13 +21,73 @@ public:
   TrajectoryGenerator();
   virtual ~TrajectoryGenerator();
 
-  static CartesianTrajectory GenerateTrajectory(const Vehicle &ego_vehicle,
-                                       const vector<double> &prev_path_x,
-                                       const vector<double> &prev_path_y,
-                                       double prev_path_last_s,
-                                       double prev_path_last_d,
-                                       int proposed_lane,
-                                       double ref_velocity);
+  /**
+   * @param velocities  velocity in miles/hour of each new point (after previous path),
+   * if there are fewer values than new points last one is kept
+   */
+  CartesianTrajectory GenerateTrajectory(const Vehicle &ego_vehicle,
+                                         const vector<double> &prev_path_x,
+                                         const vector<double> &prev_path_y,
+                                         double prev_path_last_s,
+                                         double prev_path_last_d,
+                                         int proposed_lane,
+                                         const TrajectoryValues &velocities,
+                                         PlannerWorkspace &workspace);
+
+  /**
+   * Same as above but spline passes through given Frenet anchors instead of
+   * center of proposed lane 30, 60 and 90 meters ahead. Anchor s values are
+   * offsets from end of previous path (or ego vehicle if there is none).
+   */
+  CartesianTrajectory GenerateTrajectory(const Vehicle &ego_vehicle,
+                                         const vector<double> &prev_path_x,
+                                         const vector<double> &prev_path_y,
+                                         double prev_path_last_s,
+                                         double prev_path_last_d,
+                                         const TrajectoryValues &anchor_s_offsets,
+                                         const TrajectoryValues &anchor_d_values,
+                                         int proposed_lane,
+                                         const TrajectoryValues &velocities,
+                                         PlannerWorkspace &workspace);
+
+  /**
+   * Same trajectories as first GenerateTrajectory() for each of proposed lanes
+   * and each of velocity variants, in one call. Previous path, reference point
+   * and yaw, reference line lookups of anchors and coordinate transforms are
+   * done once for all lanes, so each extra lane only costs a spline fit and its
+   * points. Spline of a lane is fitted once and sampled with every variant, so
+   * each extra variant only costs its points. Lane splines are kept across
+   * calls and reused while previous path still ends on them, so new points
+   * may continue on a curve fitted up to 10 meters back.
+   * @returns trajectory of lane i and variant j at i * variants count + j
+   */
+  ArenaVector<CartesianTrajectory> GenerateTrajectories(const Vehicle &ego_vehicle,
+                                                        const vector<double> &prev_path_x,
+                                                        const vector<double> &prev_path_y,
+                                                        double prev_path_last_s,
+                                                        double prev_path_last_d,
+                                                        const ArenaVector<int> &proposed_lanes,
+                                                        const ArenaVector<TrajectoryValues> &velocity_variants,
+                                                        PlannerWorkspace &workspace);
+
+  /**
+   * Fits and caches splines GenerateTrajectories() will need for proposed
+   * lanes when previous path ends like given path, so they don't have to
+   * be fitted then. Meant to be called with end of path just sent while
+   * waiting for next telemetry, only last two points of path are needed.
+   */
+  void PrecomputeSplines(const Vehicle &ego_vehicle,
+                         const vector<double> &path_x,
+                         const vector<double> &path_y,
+                         double path_last_s,
+                         double path_last_d,
+                         const ArenaVector<int> &proposed_lanes);
+
+private:
+  //spline of each lane fitted in earlier calls, with scratch vectors
+  //of fitting. Defined in trajectory_generator.cpp as splines are
+  struct LaneSplineCache;
+  unique_ptr<LaneSplineCache> lane_spline_cache_;
 };
 
 #endif /* TRAJECTORY_GENERATOR_H_ */
@@ -48,8 +48,8 @@ public:
    * Method to print a 1D vector. Vector type can be either primitive or
    * a custom type that has overloaded stream insertion operator (<<).
    */
-  template<class T>
-  static void print_vector(const vector<T> &values) {
+  template<class T, class A>
+  static void print_vector(const vector<T, A> &values) {
     for (int i = 0; i < values.size(); ++i) {
       cout << values[i];
 
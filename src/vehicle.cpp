@@ -95,9 +95,24 @@ vector<double> Vehicle::state_at(double t) const {
   /*
    Predicts state of vehicle in t seconds (assuming constant acceleration)
    */
-  double s = this->s + this->v * t + this->a * t * t / 2;
-  double v = this->v + this->a * t;
-  return {double(this->lane), s, v, this->a};
+  return {double(this->lane), s_at(t), v_at(t), this->a};
+}
+
+double Vehicle::s_at(double t) const {
+  double moving_t = moving_time(this->v, this->a, t);
+  return this->s + this->v * moving_t + this->a * moving_t * moving_t / 2;
+}
+
+double Vehicle::v_at(double t) const {
+  return this->v + this->a * moving_time(this->v, this->a, t);
+}
+
+double Vehicle::moving_time(double v, double a, double t) {
+  if (a >= 0) {
+    return t;
+  }
+  //stops at -v / a, already stopped if it is not moving forward
+  return min(t, max(0.0, -v / a));
 }
 
 vector<vector<double> > Vehicle::generate_predictions(double horizon) {
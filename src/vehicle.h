@@ -62,6 +62,21 @@ public:
 
   vector<double> state_at(double t) const;
 
+  /**
+   * Same prediction as state_at() for a single value, without building a vector.
+   * Used in per-timestep loops.
+   */
+  double s_at(double t) const;
+  double v_at(double t) const;
+
+  /**
+   * Constant acceleration model, except that a braking vehicle stops
+   * and stays there instead of backing up
+   * @returns how much of t a vehicle with velocity v and acceleration a
+   * is still moving, predictions are evaluated at that time
+   */
+  static double moving_time(double v, double a, double t);
+
   vector<vector<double> > generate_predictions(double horizon=1);
 
 private:
@@ -0,0 +1,128 @@
+/*
+ * vehicle_tracker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "vehicle_tracker.h"
+
+VehicleTracker::VehicleTracker(int capacity)
+    : filters_(capacity) {
+  is_used_.assign(capacity, false);
+  ids_.assign(capacity, -1);
+  x_.assign(capacity, 0);
+  y_.assign(capacity, 0);
+  missed_updates_.assign(capacity, 0);
+
+  //lowest slots are taken first
+  free_slots_.reserve(capacity);
+  for (int slot = capacity - 1; slot >= 0; --slot) {
+    free_slots_.push_back(slot);
+  }
+  updated_slots_.reserve(capacity);
+  slots_by_id_.assign(capacity, -1);
+}
+
+VehicleTracker::~VehicleTracker() {
+}
+
+int VehicleTracker::AcquireSlot(int id) {
+  if (id >= (int) slots_by_id_.size()) {
+    slots_by_id_.resize(max(id + 1, 2 * (int) slots_by_id_.size()), -1);
+  }
+
+  int slot = slots_by_id_[id];
+  if (slot != -1) {
+    return slot;
+  }
+
+  if (free_slots_.empty()) {
+    //more vehicles than capacity, grow all slot arrays
+    const int capacity = is_used_.size();
+    const int new_capacity = max(1, 2 * capacity);
+    is_used_.resize(new_capacity, false);
+    ids_.resize(new_capacity, -1);
+    x_.resize(new_capacity, 0);
+    y_.resize(new_capacity, 0);
+    missed_updates_.resize(new_capacity, 0);
+    filters_.Resize(new_capacity);
+    updated_slots_.reserve(new_capacity);
+    for (int new_slot = new_capacity - 1; new_slot >= capacity; --new_slot) {
+      free_slots_.push_back(new_slot);
+    }
+  }
+
+  slot = free_slots_.back();
+  free_slots_.pop_back();
+
+  slots_by_id_[id] = slot;
+  is_used_[slot] = true;
+  ids_[slot] = id;
+  missed_updates_[slot] = 0;
+
+  return slot;
+}
+
+void VehicleTracker::ReleaseSlot(int slot) {
+  slots_by_id_[ids_[slot]] = -1;
+  is_used_[slot] = false;
+  ids_[slot] = -1;
+  free_slots_.push_back(slot);
+}
+
+void VehicleTracker::Update(const vector<vector<double> > &sensor_fusion_data, double elapsed_time) {
+  //every tracked vehicle misses this update until it is seen
+  const int capacity = is_used_.size();
+  for (int slot = 0; slot < capacity; ++slot) {
+    if (is_used_[slot]) {
+      ++missed_updates_[slot];
+    }
+  }
+
+  //filters of vehicles not reported this time only predict
+  filters_.Predict(elapsed_time);
+  filters_.ClearMeasurements();
+
+  updated_slots_.clear();
+  for (int i = 0; i < sensor_fusion_data.size(); ++i) {
+    const vector<double> &data = sensor_fusion_data[i];
+    int id = data[0];
+    bool is_new = id >= (int) slots_by_id_.size() || slots_by_id_[id] == -1;
+    int slot = AcquireSlot(id);
+    updated_slots_.push_back(slot);
+
+    //calculate total velocity
+    double v = sqrt(data[3] * data[3] + data[4] * data[4]);
+    if (is_new) {
+      filters_.Initialize(slot, data[5], v, data[6]);
+    } else {
+      filters_.SetMeasurement(slot, data[5], v, data[6]);
+    }
+
+    x_[slot] = data[1];
+    y_[slot] = data[2];
+    missed_updates_[slot] = 0;
+  }
+  filters_.Update();
+
+  //vehicles gone for a while (out of sensor range) free their slots
+  for (int slot = 0; slot < capacity; ++slot) {
+    if (is_used_[slot] && missed_updates_[slot] > MAX_MISSED_UPDATES) {
+      ReleaseSlot(slot);
+    }
+  }
+}
+
+void VehicleTracker::ExtractVehicles(vector<Vehicle> &vehicles) const {
+  vehicles.clear();
+
+  const int updated_count = updated_slots_.size();
+  for (int i = 0; i < updated_count; ++i) {
+    int slot = updated_slots_[i];
+    double a = max(-MAX_ACCELERATION, min(MAX_ACCELERATION, filters_.A(slot)));
+    vehicles.push_back(Vehicle(ids_[slot], x_[slot], y_[slot], filters_.S(slot), filters_.D(slot), 0, filters_.V(slot), a));
+  }
+}
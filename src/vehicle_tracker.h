@@ -0,0 +1,71 @@
+/*
+ * vehicle_tracker.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef VEHICLE_TRACKER_H_
+#define VEHICLE_TRACKER_H_
+
+#include <vector>
+#include "vehicle.h"
+#include "kalman_filter_bank.h"
+
+using namespace std;
+
+/**
+ * Keeps state of every vehicle reported by sensor fusion across cycles so
+ * that their acceleration can be estimated, sensor fusion itself only gives
+ * noisy position and velocity of this moment.
+ *
+ * Positions and velocities are smoothed, and acceleration estimated, by a
+ * Kalman filter per vehicle (KalmanFilterBank). State is kept in flat arrays
+ * indexed by slot. Sensor fusion ids are small non-negative integers so id to
+ * slot map is a plain array indexed by id. Slots of vehicles not reported for
+ * a few cycles are put back on a free list and reused, so after warm-up
+ * Update() does not allocate.
+ */
+class VehicleTracker {
+public:
+  explicit VehicleTracker(int capacity = 256);
+  virtual ~VehicleTracker();
+
+  /**
+   * @param sensor_fusion_data  [ id, x, y, vx, vy, s, d] of each vehicle
+   * @param elapsed_time  seconds since last update, 0 if unknown
+   */
+  void Update(const vector<vector<double> > &sensor_fusion_data, double elapsed_time);
+
+  /**
+   * Fills vehicles with tracked state of vehicles in last update,
+   * in same order as in sensor fusion data
+   */
+  void ExtractVehicles(vector<Vehicle> &vehicles) const;
+
+private:
+  int AcquireSlot(int id);
+  void ReleaseSlot(int slot);
+
+  //id -> slot, -1 if id is not tracked
+  vector<int> slots_by_id_;
+  vector<int> free_slots_;
+  //slots of vehicles in last update, in sensor fusion order
+  vector<int> updated_slots_;
+
+  //state of each slot
+  vector<bool> is_used_;
+  vector<int> ids_;
+  vector<double> x_;
+  vector<double> y_;
+  //updates in a row in which vehicle was not reported
+  vector<int> missed_updates_;
+  //s, v, a and d of each slot
+  KalmanFilterBank filters_;
+
+  //estimates beyond this are noise or a glitch
+  const double MAX_ACCELERATION = 5; // m/s^2
+  const int MAX_MISSED_UPDATES = 5;
+};
+
+#endif /* VEHICLE_TRACKER_H_ */